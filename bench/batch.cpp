@@ -0,0 +1,129 @@
+#include "batch.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr int state_count = 1 << 17;
+constexpr int letters = 16;
+
+// Large random DFA, its table doesn't fit in cache: every step is a miss
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> any{ 0, state_count - 1 };
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+
+    for(int state = 0; state < state_count; ++state) {
+        if(state % 2 == 0) {
+            builder.set_accepting_state(state);
+        }
+
+        for(int letter = 0; letter < letters; ++letter) {
+            auto const ch = static_cast<char>('a' + letter);
+            builder.add_transition(state, ch, any(gen));
+        }
+    }
+
+    return builder;
+}
+
+// Short to medium strings
+[[nodiscard]] auto make_inputs(std::size_t const count)
+    -> std::vector<std::string>
+{
+    std::mt19937 gen{ 7 };
+    std::uniform_int_distribution<std::size_t> length{ 16U, 512U };
+    std::uniform_int_distribution<int> letter{ 0, letters - 1 };
+    std::vector<std::string> inputs{};
+
+    for(std::size_t i = 0; i < count; ++i) {
+        std::string input{};
+        for(auto size = length(gen); input.size() < size;) {
+            input.push_back(static_cast<char>('a' + letter(gen)));
+        }
+        inputs.push_back(std::move(input));
+    }
+
+    return inputs;
+}
+
+template<typename F>
+[[nodiscard]] auto ns_per_byte(std::size_t const bytes_per_run, F&& run)
+    -> double
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds{ 500 };
+
+    std::size_t bytes{ 0 };
+    std::size_t accepted{ 0 };
+    auto const start = clock::now();
+
+    do {
+        accepted += run();
+        bytes += bytes_per_run;
+    } while(clock::now() - start < budget);
+
+    // keeps the runs from being optimized away
+    if(accepted == static_cast<std::size_t>(-1)) {
+        std::cerr << accepted;
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    return elapsed.count() / static_cast<double>(bytes);
+}
+
+template<std::size_t Lanes>
+auto report(fsm::dfa const& automaton,
+            std::vector<std::string_view> const& views,
+            std::size_t const bytes,
+            double const baseline) -> void
+{
+    std::vector<bool> verdicts{};
+    auto const batch = ns_per_byte(bytes, [&] {
+        verdicts = fsm::accepts_batch<Lanes>(automaton, views);
+        return static_cast<std::size_t>(verdicts.front());
+    });
+
+    std::cout << Lanes << " lanes: " << batch << " ns/byte ("
+              << baseline / batch << "x)\n";
+}
+
+} // namespace
+
+auto main() -> int
+{
+    fsm::dfa const automaton{ make_builder() };
+    auto const inputs = make_inputs(4096U);
+    std::vector<std::string_view> const views(inputs.begin(), inputs.end());
+
+    std::size_t bytes{ 0 };
+    for(auto const& input : inputs) {
+        bytes += input.size();
+    }
+
+    auto const single = ns_per_byte(bytes, [&] {
+        std::size_t accepted{ 0 };
+        for(auto const view : views) {
+            accepted += fsm::accepts(automaton, view) ? 1U : 0U;
+        }
+        return accepted;
+    });
+
+    std::cout << "one input at a time: " << single << " ns/byte\n";
+    report<4>(automaton, views, bytes, single);
+    report<8>(automaton, views, bytes, single);
+    report<16>(automaton, views, bytes, single);
+}
@@ -0,0 +1,110 @@
+#include "compact.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
+
+namespace {
+
+constexpr int letters = 16;
+
+// Random DFA over 16 letters, half of its states accepting
+[[nodiscard]] auto make_builder(int const state_count) -> fsm::builder
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> any{ 0, state_count - 1 };
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+
+    for(int state = 0; state < state_count; ++state) {
+        if(state % 2 == 0) {
+            builder.set_accepting_state(state);
+        }
+
+        for(int letter = 0; letter < letters; ++letter) {
+            auto const ch = static_cast<char>('a' + letter);
+            builder.add_transition(state, ch, any(gen));
+        }
+    }
+
+    return builder;
+}
+
+[[nodiscard]] auto make_input(std::size_t const size) -> std::string
+{
+    std::mt19937 gen{ 7 };
+    std::uniform_int_distribution<int> letter{ 0, letters - 1 };
+    std::string input{};
+
+    while(input.size() < size) {
+        input.push_back(static_cast<char>('a' + letter(gen)));
+    }
+
+    return input;
+}
+
+template<typename Engine>
+[[nodiscard]] auto ns_per_byte(Engine const& engine, std::string const& input)
+    -> double
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds{ 500 };
+
+    std::size_t bytes{ 0 };
+    std::size_t accepted{ 0 };
+    auto const start = clock::now();
+
+    do {
+        accepted += fsm::accepts(engine, input) ? 1U : 0U;
+        bytes += input.size();
+    } while(clock::now() - start < budget);
+
+    // keeps the runs from being optimized away
+    if(accepted == static_cast<std::size_t>(-1)) {
+        std::cerr << accepted;
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    return elapsed.count() / static_cast<double>(bytes);
+}
+
+auto report(int const state_count, std::string const& input) -> void
+{
+    fsm::dfa const automaton{ make_builder(state_count) };
+    auto const& table = automaton.table();
+    auto const table_bytes =
+        table.state_count() * table.class_count() * sizeof(int);
+    auto const baseline = ns_per_byte(automaton, input);
+
+    std::cout << state_count << " states\n"
+              << "  int ids: " << table_bytes << " bytes, " << baseline
+              << " ns/byte\n";
+
+    fsm::visit_compact(automaton, [&](auto const& compact) {
+        using id = typename std::decay_t<decltype(compact)>::run_state;
+        auto const narrow = ns_per_byte(compact, input);
+
+        std::cout << "  " << sizeof(id) << "-byte ids: "
+                  << compact.memory_footprint() << " bytes, " << narrow
+                  << " ns/byte (" << baseline / narrow << "x)\n";
+    });
+}
+
+} // namespace
+
+auto main() -> int
+{
+    auto const input = make_input(1U << 20U);
+
+    for(int const state_count : { 200, 4000, 60000, 1 << 18 }) {
+        report(state_count, input);
+    }
+}
@@ -0,0 +1,342 @@
+#include "automata.hpp"
+#include "bit_nfa.hpp"
+#include "closure.hpp"
+#include "dfa.hpp"
+#include "equivalence.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "spec.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Runs an automaton through lnfa -> nfa -> dfa -> min-dfa and compares the
+// four engines on the same generated corpus: they must agree on every input,
+// then their throughput, memory footprint and conversion cost are reported
+// side by side. Takes spec files as arguments (see spec.hpp), or runs a few
+// built-in automata without any.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Half random walks along the transitions, so plenty of inputs are accepted,
+// half random bytes of the alphabet plus one it doesn't have
+[[nodiscard]] auto make_corpus(fsm::builder const& build,
+                               std::size_t const count,
+                               std::size_t const max_length)
+    -> std::vector<std::string>
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<std::size_t> length{ 0U, max_length };
+    std::string alphabet{};
+
+    for(char const ch : build.get_alphabet()) {
+        if(ch != fsm::lambda) {
+            alphabet.push_back(ch);
+        }
+    }
+    alphabet.push_back('#');
+
+    std::uniform_int_distribution<std::size_t> byte{ 0U,
+                                                     alphabet.size() - 1U };
+    auto const& autom = build.get_configuration();
+    std::vector<std::string> corpus{};
+
+    for(std::size_t i = 0; i < count; ++i) {
+        std::string input{};
+        auto const size = length(gen);
+
+        if(i % 2U == 1U) {
+            while(input.size() < size) {
+                input.push_back(alphabet[byte(gen)]);
+            }
+            corpus.push_back(std::move(input));
+            continue;
+        }
+
+        int state = build.get_starting_state();
+        while(input.size() < size) {
+            auto const it = autom.find(state);
+            if(it == autom.end() || it->second.empty()) {
+                break;
+            }
+
+            std::uniform_int_distribution<std::size_t> pick{
+                0U, it->second.size() - 1U
+            };
+            auto const& transition = it->second[pick(gen)];
+
+            if(transition.on != fsm::lambda) {
+                input.push_back(transition.on);
+            }
+            state = transition.to;
+        }
+        corpus.push_back(std::move(input));
+    }
+
+    return corpus;
+}
+
+// Approximate heap bytes of a builder: one map node per state, the
+// transitions, and per-state attributes
+[[nodiscard]] auto footprint(fsm::builder const& build) -> std::size_t
+{
+    constexpr std::size_t map_node = 48U;
+    std::size_t bytes{ 0 };
+
+    for(auto const& [state, transitions] : build.get_configuration()) {
+        static_cast<void>(state);
+        bytes += map_node + sizeof(transitions) +
+                 transitions.capacity() * sizeof(fsm::impl::transition) + 1U;
+    }
+
+    return bytes;
+}
+
+// Bytes of the table matching goes through: transitions, byte classes,
+// attributes and builder ids
+[[nodiscard]] auto footprint(fsm::dfa const& dfa) -> std::size_t
+{
+    constexpr std::size_t byte_count = 256U;
+    auto const& table = dfa.table();
+    auto const states = table.state_count();
+
+    return states * table.class_count() * sizeof(int) +
+           byte_count * sizeof(std::uint16_t) +
+           states * (sizeof(std::uint8_t) + sizeof(int));
+}
+
+[[nodiscard]] auto microseconds(clock_type::duration const elapsed) -> double
+{
+    return std::chrono::duration<double, std::micro>{ elapsed }.count();
+}
+
+template<typename Engine>
+[[nodiscard]] auto ns_per_byte(Engine const& engine,
+                               std::vector<std::string> const& corpus)
+    -> double
+{
+    constexpr auto budget = std::chrono::milliseconds{ 200 };
+
+    std::size_t bytes{ 0 };
+    std::size_t accepted{ 0 };
+    auto const start = clock_type::now();
+
+    do {
+        for(auto const& input : corpus) {
+            accepted += fsm::accepts(engine, input) ? 1U : 0U;
+            bytes += input.size();
+        }
+    } while(clock_type::now() - start < budget);
+
+    // keeps the loop from being optimized away
+    if(accepted == static_cast<std::size_t>(-1)) {
+        std::cerr << accepted;
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock_type::now() - start;
+    return elapsed.count() / static_cast<double>(bytes == 0U ? 1U : bytes);
+}
+
+[[nodiscard]] auto escape(std::string const& input) -> std::string
+{
+    std::string result{ "\"" };
+
+    for(char const ch : input) {
+        if(ch == fsm::lambda) {
+            result += "\\0";
+        }
+        else {
+            result.push_back(ch);
+        }
+    }
+
+    return result + '"';
+}
+
+class row
+{
+public:
+    char const* engine{ "" };
+    std::size_t states{ 0 };
+    double convert_us{ 0.0 };
+    std::size_t bytes{ 0 };
+    double ns_per_byte{ 0.0 };
+};
+
+// false when the engines disagree
+[[nodiscard]] auto run(std::string const& name, fsm::builder const& build)
+    -> bool
+{
+    std::cout << "== " << name << '\n';
+
+    auto const corpus = make_corpus(build, 4096U, 64U);
+    std::vector<row> rows{};
+
+    auto start = clock_type::now();
+    fsm::lnfa lnfa{ build };
+    rows.push_back(row{ "lnfa",
+                        fsm::impl::state_count(build),
+                        microseconds(clock_type::now() - start),
+                        footprint(build),
+                        0.0 });
+
+    start = clock_type::now();
+    auto const nfa_build = lnfa.to_nfa();
+    fsm::nfa nfa{ nfa_build };
+    rows.push_back(row{ "nfa",
+                        fsm::impl::state_count(nfa_build),
+                        microseconds(clock_type::now() - start),
+                        footprint(nfa_build),
+                        0.0 });
+
+    start = clock_type::now();
+    auto const dfa_build = nfa.to_dfa();
+    fsm::dfa dfa{ dfa_build };
+    rows.push_back(row{ "dfa",
+                        dfa.table().state_count(),
+                        microseconds(clock_type::now() - start),
+                        footprint(dfa),
+                        0.0 });
+
+    start = clock_type::now();
+    fsm::dfa min_dfa{ dfa.minimize() };
+    rows.push_back(row{ "min-dfa",
+                        min_dfa.table().state_count(),
+                        microseconds(clock_type::now() - start),
+                        footprint(min_dfa),
+                        0.0 });
+
+    // straight from the builder, when its live states fit
+    using bit_nfa = fsm::basic_bit_nfa<4>;
+    std::optional<bit_nfa> bits{};
+
+    start = clock_type::now();
+    try {
+        bits.emplace(build);
+        rows.push_back(row{ "bit-nfa",
+                            bits->state_count(),
+                            microseconds(clock_type::now() - start),
+                            bits->memory_footprint(),
+                            0.0 });
+    }
+    catch(std::invalid_argument const&) {
+        std::cout << "  too many states for the bit-parallel NFA\n";
+    }
+
+    std::size_t disagreements{ 0 };
+    std::size_t accepted{ 0 };
+
+    for(auto const& input : corpus) {
+        bool const lnfa_verdict = fsm::accepts(lnfa, input);
+        bool const verdicts[] = {
+            lnfa_verdict,
+            fsm::accepts(nfa, input),
+            fsm::accepts(dfa, input),
+            fsm::accepts(min_dfa, input),
+            bits.has_value() ? fsm::accepts(*bits, input) : lnfa_verdict
+        };
+
+        accepted += lnfa_verdict ? 1U : 0U;
+
+        if(std::all_of(std::begin(verdicts),
+                       std::end(verdicts),
+                       [&](bool const verdict) {
+                           return verdict == lnfa_verdict;
+                       })) {
+            continue;
+        }
+
+        if(++disagreements <= 5U) {
+            std::cout << "  disagreement on " << escape(input) << ":";
+            for(std::size_t i = 0; i < rows.size(); ++i) {
+                std::cout << ' ' << rows[i].engine << '='
+                          << (verdicts[i] ? "accept" : "reject");
+            }
+            std::cout << '\n';
+        }
+    }
+
+    // the sample can miss a difference, the equivalence checks can't
+    std::pair<char const*, fsm::equivalence> const exact[] = {
+        { "lnfa -> nfa", fsm::equivalent(build, nfa_build) },
+        { "nfa -> dfa", fsm::equivalent(nfa_build, dfa_build) },
+        { "dfa -> min-dfa", fsm::equivalent(dfa, min_dfa) },
+    };
+
+    for(auto const& [step, verdict] : exact) {
+        if(!verdict.equal) {
+            ++disagreements;
+            std::cout << "  " << step << " changed the language, it differs on "
+                      << escape(verdict.counterexample) << '\n';
+        }
+    }
+
+    rows[0].ns_per_byte = ns_per_byte(lnfa, corpus);
+    rows[1].ns_per_byte = ns_per_byte(nfa, corpus);
+    rows[2].ns_per_byte = ns_per_byte(dfa, corpus);
+    rows[3].ns_per_byte = ns_per_byte(min_dfa, corpus);
+    if(bits.has_value()) {
+        rows[4].ns_per_byte = ns_per_byte(*bits, corpus);
+    }
+
+    std::cout << "  " << corpus.size() << " inputs, " << accepted
+              << " accepted, " << disagreements << " disagreements\n";
+    std::cout << "  " << std::left << std::setw(10) << "engine"
+              << std::right << std::setw(8) << "states" << std::setw(14)
+              << "convert us" << std::setw(12) << "bytes" << std::setw(12)
+              << "ns/byte" << '\n';
+
+    for(auto const& current : rows) {
+        std::cout << "  " << std::left << std::setw(10) << current.engine
+                  << std::right << std::setw(8) << current.states
+                  << std::setw(14) << std::fixed << std::setprecision(1)
+                  << current.convert_us << std::setw(12) << current.bytes
+                  << std::setw(12) << std::setprecision(2)
+                  << current.ns_per_byte << '\n';
+    }
+
+    return disagreements == 0U;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    std::vector<std::pair<std::string, fsm::builder>> automata{};
+
+    for(int i = 1; i < argc; ++i) {
+        std::ifstream spec{ argv[i] };
+        automata.emplace_back(argv[i], fsm::read_spec(spec));
+    }
+
+    if(automata.empty()) {
+        automata.emplace_back("lambda-heavy", make_lambda_heavy());
+        automata.emplace_back("(a|b)*a(a|b){4}", make_blowup(4));
+        automata.emplace_back("(a|b)*a(a|b){10}", make_blowup(10));
+    }
+
+    bool agreed{ true };
+    for(auto const& [name, build] : automata) {
+        agreed = run(name, build) && agreed;
+    }
+
+    return agreed ? 0 : 1;
+}
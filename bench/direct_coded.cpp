@@ -0,0 +1,112 @@
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "jit.hpp"
+#include "spec.hpp"
+
+#include "a_ab_star_b.hpp"
+#include "identifier.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+// a(a|b)*b, unpredictable branches
+[[nodiscard]] auto make_input(std::size_t const size) -> std::string
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> dist{ 0, 1 };
+    std::string input{ "a" };
+
+    while(input.size() + 1U < size) {
+        input.push_back(dist(gen) == 0 ? 'a' : 'b');
+    }
+    input.push_back('b');
+
+    return input;
+}
+
+// identifier whose bytes all take the same branch
+[[nodiscard]] auto make_identifier(std::size_t const size) -> std::string
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> dist{ 'a', 'z' };
+    std::string input{ "_" };
+
+    while(input.size() < size) {
+        input.push_back(static_cast<char>(dist(gen)));
+    }
+
+    return input;
+}
+
+[[nodiscard]] auto load(char const* path) -> fsm::dfa
+{
+    std::ifstream spec{ path };
+    return fsm::dfa{ fsm::dfa{ fsm::read_spec(spec) }.minimize() };
+}
+
+template<typename F>
+[[nodiscard]] auto ns_per_byte(std::string const& input, F&& run) -> double
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds{ 200 };
+
+    std::size_t bytes{ 0 };
+    bool accepted{ true };
+    auto const start = clock::now();
+
+    do {
+        accepted = run() && accepted;
+        bytes += input.size();
+    } while(clock::now() - start < budget);
+
+    if(!accepted) {
+        std::cerr << "input rejected, timings are meaningless\n";
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    return elapsed.count() / static_cast<double>(bytes);
+}
+
+template<typename Matcher>
+auto compare(char const* name,
+             fsm::dfa const& dfa,
+             Matcher const& matcher,
+             std::string const& input) -> void
+{
+    auto const table = ns_per_byte(
+        input, [&dfa, &input] { return fsm::accepts(dfa, input); });
+    auto const direct =
+        ns_per_byte(input, [&matcher, &input] { return matcher(input); });
+
+    fsm::jit const compiled{ dfa };
+    auto const jitted = ns_per_byte(
+        input, [&compiled, &input] { return compiled.accepts(input); });
+
+    std::cout << name << ": table-driven " << table
+              << " ns/byte, direct-coded " << direct << " ns/byte, jit "
+              << jitted << " ns/byte" << (compiled.native() ? "" : " (table)")
+              << '\n';
+}
+
+} // namespace
+
+auto main() -> int
+{
+    constexpr std::size_t size = 1U << 16U;
+
+    compare("a(a|b)*b",
+            load(SPEC_DIR "/a_ab_star_b.lfa"),
+            fsm::generated::a_ab_star_b,
+            make_input(size));
+    compare("identifier",
+            load(TEST_SPEC_DIR "/identifier.lfa"),
+            fsm::generated::identifier,
+            make_identifier(size));
+}
@@ -0,0 +1,199 @@
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "layout.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int state_count = 1 << 17;
+constexpr int hot_count = 1 << 10;
+constexpr int letters = 16;
+
+// Large random DFA: 15 letters out of 16 lead to one of a few hot states, the
+// last one to any state. Builder ids are shuffled so the hot states are
+// scattered all over the table.
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> hot{ 0, hot_count - 1 };
+    std::uniform_int_distribution<int> any{ 0, state_count - 1 };
+
+    std::vector<int> ids(static_cast<std::size_t>(state_count));
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), gen);
+
+    auto const id = [&ids](int const state) -> int {
+        return ids[static_cast<std::size_t>(state)];
+    };
+
+    fsm::builder builder{};
+    builder.set_starting_state(id(0));
+
+    for(int state = 0; state < state_count; ++state) {
+        builder.set_accepting_state(id(state));
+
+        for(int letter = 0; letter < letters; ++letter) {
+            auto const ch = static_cast<char>('a' + letter);
+            int const to = letter + 1 < letters ? hot(gen) : any(gen);
+
+            builder.add_transition(id(state), ch, id(to));
+        }
+    }
+
+    return builder;
+}
+
+[[nodiscard]] auto make_input(std::size_t const size, unsigned const seed)
+    -> std::string
+{
+    std::mt19937 gen{ seed };
+    std::uniform_int_distribution<int> dist{ 0, letters - 1 };
+    std::string input{};
+
+    while(input.size() < size) {
+        input.push_back(static_cast<char>('a' + dist(gen)));
+    }
+
+    return input;
+}
+
+// Last level cache misses of this thread, when the kernel lets us count them
+class cache_misses
+{
+private:
+    int m_fd{ -1 };
+
+public:
+    cache_misses(cache_misses const&) = delete;
+    cache_misses(cache_misses&&) = delete;
+
+    cache_misses()
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        m_fd = static_cast<int>(
+            syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL));
+#endif
+    }
+
+    ~cache_misses() noexcept
+    {
+#ifdef __linux__
+        if(m_fd >= 0) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    auto operator=(cache_misses const&) -> cache_misses& = delete;
+    auto operator=(cache_misses&&) -> cache_misses& = delete;
+
+    auto start() -> void
+    {
+#ifdef __linux__
+        if(m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    [[nodiscard]] auto stop() -> std::optional<std::uint64_t>
+    {
+#ifdef __linux__
+        std::uint64_t count{ 0 };
+
+        if(m_fd >= 0) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            if(read(m_fd, &count, sizeof(count)) ==
+               static_cast<ssize_t>(sizeof(count))) {
+                return count;
+            }
+        }
+#endif
+        return std::nullopt;
+    }
+};
+
+auto measure(char const* name, fsm::dfa const& dfa, std::string const& input)
+    -> void
+{
+    using clock = std::chrono::steady_clock;
+    constexpr int rounds = 20;
+
+    cache_misses counter{};
+    bool accepted{ true };
+
+    counter.start();
+    auto const start = clock::now();
+
+    for(int i = 0; i < rounds; ++i) {
+        accepted = fsm::accepts(dfa, input) && accepted;
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    auto const misses = counter.stop();
+    auto const bytes = static_cast<double>(input.size()) * rounds;
+
+    if(!accepted) {
+        std::cerr << "input rejected, timings are meaningless\n";
+    }
+
+    std::cout << name << ": " << elapsed.count() / bytes << " ns/byte";
+    if(misses.has_value()) {
+        std::cout << ", " << static_cast<double>(*misses) * 1000.0 / bytes
+                  << " cache misses/KB";
+    }
+    else {
+        std::cout << ", cache misses unavailable";
+    }
+    std::cout << '\n';
+}
+
+} // namespace
+
+auto main() -> int
+{
+    fsm::dfa const original{ make_builder() };
+    auto const sample = make_input(1U << 16U, 7U);
+    auto const input = make_input(1U << 22U, 42U);
+
+    std::cout << original.table().state_count() << " states, "
+              << original.table().class_count() << " classes\n";
+
+    measure("builder order", original, input);
+    measure("bfs", original.with_layout(fsm::layout::bfs), input);
+    measure("frequency",
+            original.with_layout(fsm::layout::frequency, sample),
+            input);
+    measure("co-access",
+            original.with_layout(fsm::layout::co_access, sample),
+            input);
+}
@@ -0,0 +1,88 @@
+#include "fsm_builder.hpp"
+#include "lexer.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One or more characters in [first, last]
+[[nodiscard]] auto repeat(char const first, char const last) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    for(char ch = first; ch <= last; ++ch) {
+        builder.add_transition(0, ch, 1);
+        builder.add_transition(1, ch, 1);
+    }
+
+    return builder;
+}
+
+[[nodiscard]] auto make_input(std::size_t const size) -> std::string
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> kind{ 0, 2 };
+    std::uniform_int_distribution<int> length{ 1, 8 };
+    std::uniform_int_distribution<int> letter{ 0, 25 };
+    std::uniform_int_distribution<int> digit{ 0, 9 };
+    std::string input{};
+
+    while(input.size() < size) {
+        auto const n = length(gen);
+
+        for(int i = 0; i < n; ++i) {
+            switch(kind(gen)) {
+            case 0:
+                input.push_back(static_cast<char>('a' + letter(gen)));
+                break;
+            case 1:
+                input.push_back(static_cast<char>('0' + digit(gen)));
+                break;
+            default:
+                input.push_back(' ');
+                break;
+            }
+        }
+    }
+
+    return input;
+}
+
+} // namespace
+
+auto main() -> int
+{
+    using clock = std::chrono::steady_clock;
+
+    fsm::lexer const lexer{ { repeat('a', 'z'),
+                              repeat('0', '9'),
+                              repeat(' ', ' ') } };
+    auto const input = make_input(1U << 22U);
+
+    std::size_t bytes{ 0 };
+    std::size_t tokens{ 0 };
+    auto const start = clock::now();
+
+    do {
+        std::size_t position{ 0 };
+        fsm::lexer::memo scans{};
+
+        while(position < input.size()) {
+            auto const token = lexer.next_token(input, position, scans);
+            tokens += token.text.empty() ? 0U : 1U;
+        }
+        bytes += input.size();
+    } while(clock::now() - start < std::chrono::milliseconds{ 500 });
+
+    std::chrono::duration<double> const elapsed = clock::now() - start;
+
+    std::cout << "lexer: " << static_cast<double>(bytes) / 1e6 / elapsed.count()
+              << " MB/s, " << tokens << " tokens\n";
+}
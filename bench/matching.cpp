@@ -0,0 +1,102 @@
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+// a(a|b)*b, nondeterministic
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'b', 2);
+    builder.add_transition(2, 'a', 1);
+    builder.add_transition(2, 'b', 2);
+
+    return builder;
+}
+
+[[nodiscard]] auto make_input(std::size_t const size) -> std::string
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> dist{ 0, 1 };
+    std::string input{ "a" };
+
+    while(input.size() + 1U < size) {
+        input.push_back(dist(gen) == 0 ? 'a' : 'b');
+    }
+    input.push_back('b');
+
+    return input;
+}
+
+template<typename F>
+[[nodiscard]] auto ns_per_byte(std::string const& input, F&& run) -> double
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds{ 200 };
+
+    std::size_t bytes{ 0 };
+    bool accepted{ true };
+    auto const start = clock::now();
+
+    do {
+        accepted = run() && accepted;
+        bytes += input.size();
+    } while(clock::now() - start < budget);
+
+    if(!accepted) {
+        std::cerr << "input rejected, timings are meaningless\n";
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    return elapsed.count() / static_cast<double>(bytes);
+}
+
+template<typename Engine>
+auto compare(char const* name, Engine& engine, std::string const& input)
+    -> void
+{
+    auto const dynamic = ns_per_byte(input, [&engine, &input] {
+        engine.reset();
+        return fsm::accepts(static_cast<fsm::automaton&>(engine), input);
+    });
+    auto const fixed = ns_per_byte(
+        input, [&engine, &input] { return fsm::accepts(engine, input); });
+
+    std::cout << name << ": virtual " << dynamic << " ns/byte, static "
+              << fixed << " ns/byte\n";
+}
+
+} // namespace
+
+auto main() -> int
+{
+    auto const input = make_input(1U << 16U);
+
+    fsm::lnfa lnfa{ make_builder() };
+    fsm::nfa nfa{ make_builder() };
+    fsm::dfa dfa{ nfa.to_dfa() };
+    fsm::dfa min_dfa{ dfa.minimize() };
+
+    compare("lnfa", lnfa, input);
+    compare("nfa", nfa, input);
+    compare("dfa", dfa, input);
+    compare("min-dfa", min_dfa, input);
+}
@@ -0,0 +1,123 @@
+#include "cursor.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "pipeline.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr int state_count = 1 << 12;
+constexpr int letters = 16;
+
+// Random DFA over 16 letters, half of its states accepting
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    std::mt19937 gen{ 42 };
+    std::uniform_int_distribution<int> any{ 0, state_count - 1 };
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+
+    for(int state = 0; state < state_count; ++state) {
+        if(state % 2 == 0) {
+            builder.set_accepting_state(state);
+        }
+
+        for(int letter = 0; letter < letters; ++letter) {
+            auto const ch = static_cast<char>('a' + letter);
+            builder.add_transition(state, ch, any(gen));
+        }
+    }
+
+    return builder;
+}
+
+// About 64 MiB of lines of 16 to 512 letters
+auto write_input(std::filesystem::path const& path) -> void
+{
+    constexpr std::size_t size = std::size_t{ 64 } << 20U;
+    std::mt19937 gen{ 7 };
+    std::uniform_int_distribution<std::size_t> length{ 16U, 512U };
+    std::uniform_int_distribution<int> letter{ 0, letters - 1 };
+    std::ofstream out{ path, std::ios::binary };
+
+    for(std::size_t written = 0; written < size;) {
+        std::string line(length(gen), '\0');
+        for(char& ch : line) {
+            ch = static_cast<char>('a' + letter(gen));
+        }
+
+        line.push_back('\n');
+        out << line;
+        written += line.size();
+    }
+}
+
+template<typename F>
+auto report(char const* const name, F&& run) -> void
+{
+    using clock = std::chrono::steady_clock;
+
+    auto const start = clock::now();
+    auto const stats = run();
+    std::chrono::duration<double> const elapsed = clock::now() - start;
+
+    std::cout << name << ": " << stats.lines << " lines, " << stats.accepted
+              << " accepted, "
+              << static_cast<double>(stats.bytes) / elapsed.count() / 1e6
+              << " MB/s\n";
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    auto const shared = fsm::share(fsm::dfa{ make_builder() });
+    auto const path = argc > 1 ? std::filesystem::path{ argv[1] }
+                               : std::filesystem::temp_directory_path() /
+                                     "lfa_pipeline_bench.txt";
+
+    if(argc <= 1) {
+        write_input(path);
+    }
+
+    report("one thread", [&] {
+        std::ifstream input{ path, std::ios::binary };
+        fsm::cursor<fsm::dfa> matcher{ shared };
+        fsm::pipeline_stats stats{};
+
+        for(std::string line{}; std::getline(input, line);) {
+            matcher.reset();
+            matcher.feed(line);
+            stats.accepted += matcher.accepted() ? 1U : 0U;
+            stats.bytes += line.size() + 1U;
+            ++stats.lines;
+        }
+
+        return stats;
+    });
+
+    for(std::size_t const matchers : { 1U, 2U, 4U }) {
+        fsm::pipeline_options options{};
+        options.matchers = matchers;
+
+        auto const name = "pipeline, " + std::to_string(matchers) + " matchers";
+        report(name.c_str(), [&] {
+            std::ifstream input{ path, std::ios::binary };
+            return fsm::match_lines(
+                shared, input, [](std::size_t, bool) {}, options);
+        });
+    }
+
+    if(argc <= 1) {
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,109 @@
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "profile.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int state_count = 32;
+constexpr int letters = 48;
+
+// Every state has two transitions on each of 48 letters, the second ones
+// added in a separate pass so the builder doesn't group them
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+
+    for(int state = 0; state < state_count; ++state) {
+        if(state % 2 == 0) {
+            builder.set_accepting_state(state);
+        }
+        for(int letter = 0; letter < letters; ++letter) {
+            builder.add_transition(state,
+                                   static_cast<char>('0' + letter),
+                                   (state * 7 + letter) % state_count);
+        }
+        for(int letter = 0; letter < letters; ++letter) {
+            builder.add_transition(state,
+                                   static_cast<char>('0' + letter),
+                                   (state + letter) % state_count);
+        }
+    }
+
+    return builder;
+}
+
+// Skewed traffic: the letters added last are the most frequent
+[[nodiscard]] auto make_input(std::size_t const size, unsigned const seed)
+    -> std::string
+{
+    std::mt19937 gen{ seed };
+    std::geometric_distribution<int> dist{ 0.3 };
+    std::string input{};
+
+    while(input.size() < size) {
+        int const rank = dist(gen) % letters;
+        input.push_back(static_cast<char>('0' + letters - 1 - rank));
+    }
+
+    return input;
+}
+
+template<typename Engine>
+[[nodiscard]] auto ns_per_byte(Engine const& engine, std::string const& input)
+    -> double
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto budget = std::chrono::milliseconds{ 300 };
+
+    std::size_t bytes{ 0 };
+    std::size_t accepted{ 0 };
+    auto const start = clock::now();
+
+    do {
+        accepted += fsm::accepts(engine, input) ? 1U : 0U;
+        bytes += input.size();
+    } while(clock::now() - start < budget);
+
+    // keeps the runs from being optimized away
+    if(accepted == static_cast<std::size_t>(-1)) {
+        std::cerr << accepted;
+    }
+
+    std::chrono::duration<double, std::nano> const elapsed =
+        clock::now() - start;
+    return elapsed.count() / static_cast<double>(bytes);
+}
+
+} // namespace
+
+auto main() -> int
+{
+    auto const builder = make_builder();
+    // profiled on one sample, measured on another one
+    auto const counts = fsm::profile(builder, { make_input(1U << 14U, 1U) });
+    auto const optimized = fsm::optimize(builder, counts);
+    auto const input = make_input(1U << 14U, 2U);
+
+    fsm::nfa const nfa{ builder };
+    fsm::nfa const optimized_nfa{ optimized };
+    fsm::lnfa const lnfa{ builder };
+    fsm::lnfa const optimized_lnfa{ optimized };
+
+    std::cout << "nfa: builder order " << ns_per_byte(nfa, input)
+              << " ns/byte, profile-guided "
+              << ns_per_byte(optimized_nfa, input) << " ns/byte\n";
+    std::cout << "lnfa: builder order " << ns_per_byte(lnfa, input)
+              << " ns/byte, profile-guided "
+              << ns_per_byte(optimized_lnfa, input) << " ns/byte\n";
+}
@@ -0,0 +1,40 @@
+# Compiles the DFA described in SPEC (see src/spec.hpp) into a direct-coded
+# matcher and adds it to TARGET. For a spec named identifier.lfa the target
+# gets `#include "identifier.hpp"` and fsm::generated::identifier().
+#
+# NAME picks another name than the spec's, it has to be a valid C++
+# identifier: a spec named request-line.lfa needs NAME request_line.
+function(lfa_generate_matcher TARGET SPEC)
+  cmake_parse_arguments(PARSE_ARGV 2 LFA "" "NAME" "")
+
+  get_filename_component(SPEC_PATH ${SPEC} ABSOLUTE)
+  if(LFA_NAME)
+    set(NAME ${LFA_NAME})
+  else()
+    get_filename_component(NAME ${SPEC} NAME_WE)
+  endif()
+
+  # fail here rather than in the generated code
+  string(MAKE_C_IDENTIFIER "${NAME}" IDENTIFIER)
+  if(NOT NAME STREQUAL IDENTIFIER)
+    message(
+      FATAL_ERROR
+        "lfa_generate_matcher: '${NAME}' from ${SPEC} isn't a valid C++ "
+        "identifier, pass NAME ${IDENTIFIER} or another one")
+  endif()
+
+  set(OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/lfa_generated)
+  set(HEADER ${OUTPUT_DIR}/${NAME}.hpp)
+  set(SOURCE ${OUTPUT_DIR}/${NAME}.cpp)
+
+  add_custom_command(
+    OUTPUT ${HEADER} ${SOURCE}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${OUTPUT_DIR}
+    COMMAND lfa_generate ${SPEC_PATH} ${NAME} ${HEADER} ${SOURCE}
+    DEPENDS lfa_generate ${SPEC_PATH}
+    COMMENT "Generating matcher ${NAME}"
+    VERBATIM)
+
+  target_sources(${TARGET} PRIVATE ${HEADER} ${SOURCE})
+  target_include_directories(${TARGET} PRIVATE ${OUTPUT_DIR})
+endfunction()
@@ -0,0 +1,104 @@
+#include "attributes.hpp"
+#include "closure.hpp"
+#include "lnfa.hpp"
+
+#include <array>
+#include <deque>
+
+namespace fsm::impl {
+
+auto compute_attributes(builder const& build, lambda_mode const lambdas)
+    -> std::vector<std::uint8_t>
+{
+    constexpr std::size_t byte_count = 256U;
+    auto const n = impl::state_count(build);
+    auto const& autom = build.get_configuration();
+    std::vector<std::uint8_t> result(n, 0U);
+    std::vector<std::vector<std::size_t>> reverse(n);
+
+    for(auto const& [state, transitions] : autom) {
+        for(auto const& transition : transitions) {
+            reverse[static_cast<std::size_t>(transition.to)].push_back(
+                static_cast<std::size_t>(state));
+        }
+    }
+
+    // co-reachability: walk the transitions backwards from accepting states
+    std::vector<bool> alive(n, false);
+    std::deque<std::size_t> queue{};
+
+    for(int const state : build.get_accepting_states()) {
+        auto const s = static_cast<std::size_t>(state);
+
+        result[s] |= attribute::accepting;
+        if(!alive[s]) {
+            alive[s] = true;
+            queue.push_back(s);
+        }
+    }
+
+    for(; !queue.empty(); queue.pop_front()) {
+        for(std::size_t const from : reverse[queue.front()]) {
+            if(!alive[from]) {
+                alive[from] = true;
+                queue.push_back(from);
+            }
+        }
+    }
+
+    // accept-all is the greatest set of accepting states where every byte
+    // leads back into the set
+    std::vector<bool> accept_all(n, false);
+    for(auto const& [state, transitions] : autom) {
+        auto const s = static_cast<std::size_t>(state);
+        accept_all[s] = (result[s] & attribute::accepting) != 0U;
+    }
+
+    for(bool changed = true; changed;) {
+        changed = false;
+
+        for(auto const& [state, transitions] : autom) {
+            auto const s = static_cast<std::size_t>(state);
+
+            if(!accept_all[s]) {
+                continue;
+            }
+
+            std::array<bool, byte_count> covered{};
+            std::size_t count{ 0 };
+
+            for(auto const& transition : transitions) {
+                auto const byte = static_cast<unsigned char>(transition.on);
+
+                // the byte 0 stays uncovered, it leads nowhere
+                if(lambdas == lambda_mode::epsilon && transition.on == lambda) {
+                    continue;
+                }
+
+                if(accept_all[static_cast<std::size_t>(transition.to)] &&
+                   !covered[byte]) {
+                    covered[byte] = true;
+                    ++count;
+                }
+            }
+
+            if(count != byte_count) {
+                accept_all[s] = false;
+                changed = true;
+            }
+        }
+    }
+
+    for(std::size_t s = 0; s < n; ++s) {
+        if(!alive[s]) {
+            result[s] |= attribute::dead;
+        }
+        if(accept_all[s]) {
+            result[s] |= attribute::accept_all;
+        }
+    }
+
+    return result;
+}
+
+} // namespace fsm::impl
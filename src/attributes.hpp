@@ -0,0 +1,43 @@
+#ifndef ATTRIBUTES_HPP
+#define ATTRIBUTES_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace fsm::impl {
+
+// Per-state flags, packed in one byte, that let matching stop as soon as the
+// outcome is decided
+namespace attribute {
+
+inline constexpr std::uint8_t accepting = 1U << 0U;
+// no accepting state can be reached anymore
+inline constexpr std::uint8_t dead = 1U << 1U;
+// every suffix is accepted
+inline constexpr std::uint8_t accept_all = 1U << 2U;
+
+} // namespace attribute
+
+// How an engine reads transitions on fsm::lambda
+enum class lambda_mode
+{
+    // as transitions on the byte 0, followed when it reads that byte
+    byte_zero,
+    // as lambda transitions, the byte 0 then matches nothing
+    epsilon
+};
+
+// Attributes of every state of a builder, indexed by state id.
+//
+// With lambda_mode::epsilon no state accepts every suffix, since a suffix
+// holding the byte 0 is never accepted.
+[[nodiscard]] auto compute_attributes(
+    builder const& build, lambda_mode const lambdas = lambda_mode::byte_zero)
+    -> std::vector<std::uint8_t>;
+
+} // namespace fsm::impl
+
+#endif // !ATTRIBUTES_HPP
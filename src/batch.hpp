@@ -0,0 +1,129 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+#pragma once
+
+#include "dfa.hpp"
+#include "dfa_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace fsm {
+
+inline constexpr std::size_t default_lanes = 8U;
+
+// Verdicts of `automaton` on inputs[0..count), written to verdicts[0..count).
+//
+// A single input is a chain of dependent loads, one per byte, that stall
+// whenever the table doesn't fit in cache. Here `Lanes` inputs go through the
+// table in lockstep: each round takes one step in every lane and prefetches
+// the transition that lane reads next, so the misses of different lanes
+// overlap. A lane takes the next input as soon as its own is decided.
+template<std::size_t Lanes = default_lanes>
+auto accepts_batch(dfa const& automaton,
+                   std::string_view const* const inputs,
+                   std::size_t const count,
+                   bool* const verdicts) -> void;
+
+template<std::size_t Lanes = default_lanes>
+[[nodiscard]] auto accepts_batch(dfa const& automaton,
+                                 std::vector<std::string_view> const& inputs)
+    -> std::vector<bool>;
+
+namespace impl {
+
+class lane
+{
+public:
+    char const* next{ nullptr };
+    char const* end{ nullptr };
+    std::size_t input{ 0 };
+    int state{ dfa_table::dead };
+    bool busy{ false };
+};
+
+} // namespace impl
+
+template<std::size_t Lanes>
+auto accepts_batch(dfa const& automaton,
+                   std::string_view const* const inputs,
+                   std::size_t const count,
+                   bool* const verdicts) -> void
+{
+    static_assert(Lanes > 0U, "at least one lane");
+
+    constexpr int dead = impl::dfa_table::dead;
+    auto const& table = automaton.table();
+    std::array<impl::lane, Lanes> lanes{};
+    std::size_t taken{ 0 };
+    std::size_t busy{ 0 };
+
+    auto const start = [&](impl::lane& current) {
+        current.busy = taken < count;
+        if(!current.busy) {
+            return;
+        }
+
+        current.input = taken;
+        current.next = inputs[taken].data();
+        current.end = current.next + inputs[taken].size();
+        current.state = table.start();
+        ++taken;
+        ++busy;
+
+        if(current.next != current.end) {
+            table.prefetch(current.state, *current.next);
+        }
+    };
+
+    for(auto& current : lanes) {
+        start(current);
+    }
+
+    while(busy > 0U) {
+        for(auto& current : lanes) {
+            if(!current.busy) {
+                continue;
+            }
+
+            int const state = current.state;
+            bool const decided = state == dead ||
+                                 table.accepts_all(state) ||
+                                 current.next == current.end;
+
+            if(decided) {
+                verdicts[current.input] =
+                    state != dead && table.accepting(state);
+                --busy;
+                start(current);
+                continue;
+            }
+
+            current.state = table.step(state, *current.next++);
+
+            if(current.state != dead &&
+               current.next != current.end) {
+                table.prefetch(current.state, *current.next);
+            }
+        }
+    }
+}
+
+template<std::size_t Lanes>
+auto accepts_batch(dfa const& automaton,
+                   std::vector<std::string_view> const& inputs)
+    -> std::vector<bool>
+{
+    auto const verdicts = std::make_unique<bool[]>(inputs.size());
+    accepts_batch<Lanes>(
+        automaton, inputs.data(), inputs.size(), verdicts.get());
+
+    return std::vector<bool>(verdicts.get(), verdicts.get() + inputs.size());
+}
+
+} // namespace fsm
+
+#endif // !BATCH_HPP
@@ -0,0 +1,217 @@
+#include "bit_nfa.hpp"
+#include "attributes.hpp"
+#include "closure.hpp"
+#include "lnfa.hpp"
+
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+namespace fsm::impl {
+
+namespace {
+
+constexpr int unnumbered = -1;
+
+auto set_bit(std::vector<word>& masks,
+             std::size_t const offset,
+             std::size_t const bit) -> void
+{
+    masks[offset + bit / word_bits] |= word{ 1U } << (bit % word_bits);
+}
+
+[[nodiscard]] auto is_live(std::vector<std::uint8_t> const& attributes,
+                           int const state) -> bool
+{
+    return (attributes[static_cast<std::size_t>(state)] & attribute::dead) ==
+           0U;
+}
+
+// Live states in breadth-first order from the start, lambda transitions
+// included
+[[nodiscard]] auto live_order(builder const& build,
+                              std::vector<std::uint8_t> const& attributes)
+    -> std::vector<int>
+{
+    auto const& autom = build.get_configuration();
+    std::vector<bool> seen(attributes.size(), false);
+    std::vector<int> order{};
+    int const start = build.get_starting_state();
+
+    if(!is_live(attributes, start)) {
+        return order;
+    }
+
+    std::deque<int> queue{ start };
+    seen[static_cast<std::size_t>(start)] = true;
+
+    for(; !queue.empty(); queue.pop_front()) {
+        int const state = queue.front();
+        order.push_back(state);
+
+        auto const it = autom.find(state);
+        if(it == autom.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
+            auto const to = static_cast<std::size_t>(transition.to);
+
+            if(!seen[to] && is_live(attributes, transition.to)) {
+                seen[to] = true;
+                queue.push_back(transition.to);
+            }
+        }
+    }
+
+    return order;
+}
+
+// Numbers states along chains of transitions, so each state is followed by
+// one it has a transition to whenever possible
+[[nodiscard]] auto number_chains(builder const& build,
+                                 std::vector<std::uint8_t> const& attributes,
+                                 std::vector<int> const& order)
+    -> std::vector<int>
+{
+    auto const& autom = build.get_configuration();
+    std::vector<int> number(attributes.size(), unnumbered);
+    int next{ 0 };
+
+    for(int const first : order) {
+        for(int state = first;
+            number[static_cast<std::size_t>(state)] == unnumbered;) {
+            number[static_cast<std::size_t>(state)] = next++;
+
+            auto const it = autom.find(state);
+            if(it == autom.end()) {
+                break;
+            }
+
+            for(auto const& transition : it->second) {
+                if(transition.on != lambda &&
+                   is_live(attributes, transition.to) &&
+                   number[static_cast<std::size_t>(transition.to)] ==
+                       unnumbered) {
+                    state = transition.to;
+                    break;
+                }
+            }
+        }
+    }
+
+    return number;
+}
+
+} // namespace
+
+auto compile_bit_program(builder const& build, std::size_t const words)
+    -> bit_program
+{
+    // the byte 0 matches nothing here, lambda edges cover no byte
+    auto const attributes = compute_attributes(build, lambda_mode::epsilon);
+    lambda_closures const closures{ build };
+    auto const order = live_order(build, attributes);
+    auto const number = number_chains(build, attributes, order);
+
+    if(order.size() > words * word_bits) {
+        throw std::invalid_argument{
+            std::to_string(order.size()) +
+            " live states don't fit in a bit-parallel NFA of " +
+            std::to_string(words * word_bits)
+        };
+    }
+
+    bit_program program{};
+    program.words = words;
+    program.state_count = order.size();
+
+    for(char const ch : build.get_alphabet()) {
+        if(ch != lambda) {
+            program.classes[static_cast<unsigned char>(ch)] =
+                static_cast<std::uint16_t>(program.class_count++);
+        }
+    }
+
+    auto const n = program.state_count;
+    auto const k = program.class_count;
+
+    program.start.assign(words, 0U);
+    program.accepting.assign(words, 0U);
+    program.accept_all.assign(words, 0U);
+    program.shift.assign(k * words, 0U);
+    program.loop.assign(k * words, 0U);
+    program.follow_from.assign(k * words, 0U);
+    program.follow.assign(n * k * words, 0U);
+    program.closure_from.assign(words, 0U);
+    program.closure.assign(n * words, 0U);
+
+    auto const& autom = build.get_configuration();
+
+    for(int const state : order) {
+        auto const from =
+            static_cast<std::size_t>(number[static_cast<std::size_t>(state)]);
+        auto const flags = attributes[static_cast<std::size_t>(state)];
+
+        if((flags & attribute::accepting) != 0U) {
+            set_bit(program.accepting, 0U, from);
+        }
+        if((flags & attribute::accept_all) != 0U) {
+            set_bit(program.accept_all, 0U, from);
+        }
+
+        for(int const reached : closures.of(state)) {
+            if(reached == state || !is_live(attributes, reached)) {
+                continue;
+            }
+
+            set_bit(program.closure_from, 0U, from);
+            set_bit(
+                program.closure,
+                from * words,
+                static_cast<std::size_t>(
+                    number[static_cast<std::size_t>(reached)]));
+        }
+        set_bit(program.closure, from * words, from);
+
+        auto const it = autom.find(state);
+        if(it == autom.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
+            if(transition.on == lambda || !is_live(attributes, transition.to)) {
+                continue;
+            }
+
+            auto const cls = static_cast<std::size_t>(
+                program.classes[static_cast<unsigned char>(transition.on)]);
+            auto const to = static_cast<std::size_t>(
+                number[static_cast<std::size_t>(transition.to)]);
+
+            if(to == from + 1U) {
+                set_bit(program.shift, cls * words, to);
+            }
+            else if(to == from) {
+                set_bit(program.loop, cls * words, to);
+            }
+            else {
+                set_bit(program.follow_from, cls * words, from);
+                set_bit(program.follow, (from * k + cls) * words, to);
+            }
+        }
+    }
+
+    if(!order.empty()) {
+        auto const start = static_cast<std::size_t>(
+            number[static_cast<std::size_t>(order.front())]);
+
+        for(std::size_t w = 0; w < words; ++w) {
+            program.start[w] = program.closure[start * words + w];
+        }
+    }
+
+    return program;
+}
+
+} // namespace fsm::impl
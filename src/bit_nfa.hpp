@@ -0,0 +1,214 @@
+#ifndef BIT_NFA_HPP
+#define BIT_NFA_HPP
+#pragma once
+
+#include "bits.hpp"
+#include "fsm_builder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fsm {
+
+namespace impl {
+
+using word = std::uint64_t;
+inline constexpr std::size_t word_bits = 64U;
+
+// Masks of a bit-parallel NFA, every mask is `words` words long.
+//
+// States are numbered so that as many transitions as possible go from a state
+// to the next one: those are taken for every active state at once by a shift,
+// and self loops by a mask. The other transitions come from a follow table,
+// looked up only for the active states that have some.
+class bit_program
+{
+public:
+    std::size_t words{ 1 };
+    std::size_t state_count{ 0 };
+    // byte -> class, class 0 has no transitions at all
+    std::array<std::uint16_t, 256> classes{};
+    std::size_t class_count{ 1 };
+
+    std::vector<word> start{};
+    std::vector<word> accepting{};
+    std::vector<word> accept_all{};
+    // class -> states reached from the previous state on it
+    std::vector<word> shift{};
+    // class -> states with a transition to themselves on it
+    std::vector<word> loop{};
+    // class -> states with transitions not going to the next state
+    std::vector<word> follow_from{};
+    // (state, class) -> states reached through those transitions
+    std::vector<word> follow{};
+    // states whose lambda closure holds other states
+    std::vector<word> closure_from{};
+    // state -> its lambda closure
+    std::vector<word> closure{};
+};
+
+// Throws std::invalid_argument if the states that can reach an accepting state
+// don't fit in `words` words
+[[nodiscard]] auto compile_bit_program(builder const& build,
+                                       std::size_t const words) -> bit_program;
+
+} // namespace impl
+
+// Bit-parallel simulation of a (lambda-)NFA of up to 64 * Words states: the
+// set of active states is Words integers and a step is a shift and a mask,
+// plus a lookup per active state that has transitions off the chain. Nothing
+// is determinized and the memory taken doesn't depend on the input.
+//
+// Transitions on fsm::lambda are lambda transitions, the byte 0 is never
+// matched.
+template<std::size_t Words>
+class basic_bit_nfa
+{
+    static_assert(Words > 0U, "at least one word of states");
+
+private:
+    impl::bit_program m_program{};
+
+public:
+    static constexpr std::size_t max_states = Words * impl::word_bits;
+
+    basic_bit_nfa() = delete;
+    basic_bit_nfa(basic_bit_nfa const&) = default;
+    basic_bit_nfa(basic_bit_nfa&&) noexcept = default;
+    ~basic_bit_nfa() noexcept = default;
+
+    explicit basic_bit_nfa(builder const& build);
+
+    auto operator=(basic_bit_nfa const&) -> basic_bit_nfa& = default;
+    auto operator=(basic_bit_nfa&&) noexcept -> basic_bit_nfa& = default;
+
+    // live states, the ones numbered
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+    // bytes of the masks, fixed once built
+    [[nodiscard]] auto memory_footprint() const noexcept -> std::size_t;
+
+    using run_state = std::array<impl::word, Words>;
+
+    [[nodiscard]] auto initial() const noexcept -> run_state;
+    [[nodiscard]] auto step(run_state& states, char const input) const noexcept
+        -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& states) const noexcept
+        -> bool;
+};
+
+using bit_nfa = basic_bit_nfa<1>;
+
+template<std::size_t Words>
+basic_bit_nfa<Words>::basic_bit_nfa(builder const& build)
+    : m_program{ impl::compile_bit_program(build, Words) }
+{
+}
+
+template<std::size_t Words>
+auto basic_bit_nfa<Words>::state_count() const noexcept -> std::size_t
+{
+    return m_program.state_count;
+}
+
+template<std::size_t Words>
+auto basic_bit_nfa<Words>::memory_footprint() const noexcept -> std::size_t
+{
+    auto const& program = m_program;
+    auto const words =
+        program.start.size() + program.accepting.size() +
+        program.accept_all.size() + program.shift.size() +
+        program.loop.size() + program.follow_from.size() +
+        program.follow.size() + program.closure_from.size() +
+        program.closure.size();
+
+    return sizeof(program.classes) + words * sizeof(impl::word);
+}
+
+template<std::size_t Words>
+auto basic_bit_nfa<Words>::initial() const noexcept -> run_state
+{
+    run_state states{};
+
+    for(std::size_t w = 0; w < Words; ++w) {
+        states[w] = m_program.start[w];
+    }
+
+    return states;
+}
+
+template<std::size_t Words>
+auto basic_bit_nfa<Words>::step(run_state& states,
+                                char const input) const noexcept -> bool
+{
+    auto const& program = m_program;
+    auto const cls = static_cast<std::size_t>(
+        program.classes[static_cast<unsigned char>(input)]);
+    auto const* const shift = &program.shift[cls * Words];
+    auto const* const loop = &program.loop[cls * Words];
+    auto const* const follow_from = &program.follow_from[cls * Words];
+    run_state next{};
+    impl::word carry{ 0U };
+
+    for(std::size_t w = 0; w < Words; ++w) {
+        next[w] = (((states[w] << 1U) | carry) & shift[w]) |
+                  (states[w] & loop[w]);
+        carry = states[w] >> (impl::word_bits - 1U);
+    }
+
+    for(std::size_t w = 0; w < Words; ++w) {
+        for(auto bits = states[w] & follow_from[w]; bits != 0U;
+            bits &= bits - 1U) {
+            auto const state = w * impl::word_bits + impl::lowest_bit(bits);
+            auto const* const to =
+                &program.follow[(state * program.class_count + cls) * Words];
+
+            for(std::size_t v = 0; v < Words; ++v) {
+                next[v] |= to[v];
+            }
+        }
+    }
+
+    // closures are transitive, one pass over the states reached is enough
+    run_state const reached = next;
+    for(std::size_t w = 0; w < Words; ++w) {
+        for(auto bits = reached[w] & program.closure_from[w]; bits != 0U;
+            bits &= bits - 1U) {
+            auto const state = w * impl::word_bits + impl::lowest_bit(bits);
+            auto const* const to = &program.closure[state * Words];
+
+            for(std::size_t v = 0; v < Words; ++v) {
+                next[v] |= to[v];
+            }
+        }
+    }
+
+    impl::word any{ 0U };
+    impl::word decided{ 0U };
+
+    for(std::size_t w = 0; w < Words; ++w) {
+        states[w] = next[w];
+        any |= next[w];
+        decided |= next[w] & program.accept_all[w];
+    }
+
+    return any != 0U && decided == 0U;
+}
+
+template<std::size_t Words>
+auto basic_bit_nfa<Words>::is_accepting(run_state const& states) const noexcept
+    -> bool
+{
+    impl::word accepted{ 0U };
+
+    for(std::size_t w = 0; w < Words; ++w) {
+        accepted |= states[w] & m_program.accepting[w];
+    }
+
+    return accepted != 0U;
+}
+
+} // namespace fsm
+
+#endif // !BIT_NFA_HPP
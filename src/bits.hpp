@@ -0,0 +1,49 @@
+#ifndef BITS_HPP
+#define BITS_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace fsm::impl {
+
+// Index of the lowest bit set in `word`, which isn't 0
+[[nodiscard]] inline auto lowest_bit(std::uint64_t const word) noexcept
+    -> std::size_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index{ 0 };
+    _BitScanForward64(&index, word);
+
+    return static_cast<std::size_t>(index);
+#else
+    std::size_t index{ 0 };
+    for(auto rest = word; (rest & 1U) == 0U; rest >>= 1U) {
+        ++index;
+    }
+
+    return index;
+#endif
+}
+
+// Hints that `address` is read soon, a no-op where there's no such hint
+inline auto prefetch(void const* const address) noexcept -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<char const*>(address), _MM_HINT_T0);
+#else
+    static_cast<void>(address);
+#endif
+}
+
+} // namespace fsm::impl
+
+#endif // !BITS_HPP
@@ -0,0 +1,201 @@
+#include "closure.hpp"
+#include "lnfa.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace fsm::impl {
+
+auto state_count(builder const& build) -> std::size_t
+{
+    // ids index vectors: past this many per state mentioned, they are keys
+    // rather than dense ids
+    constexpr std::size_t ids_per_mention = 4U;
+    constexpr std::size_t spare_ids = 1024U;
+
+    int max_state{ 0 };
+    std::size_t mentions{ 0 };
+
+    auto const mention = [&](int const state) -> void {
+        if(state < 0) {
+            throw std::invalid_argument{ "State ids can't be negative, got " +
+                                         std::to_string(state) };
+        }
+
+        max_state = std::max(max_state, state);
+        ++mentions;
+    };
+
+    mention(build.get_starting_state());
+    for(auto const& [state, transitions] : build.get_configuration()) {
+        mention(state);
+
+        for(auto const& transition : transitions) {
+            mention(transition.to);
+        }
+    }
+    for(int const state : build.get_accepting_states()) {
+        mention(state);
+    }
+
+    auto const count = static_cast<std::size_t>(max_state) + 1U;
+
+    if(count > ids_per_mention * mentions + spare_ids) {
+        throw std::invalid_argument{ "State ids are too sparse, state " +
+                                     std::to_string(max_state) + " among " +
+                                     std::to_string(mentions) + " mentions" };
+    }
+
+    return count;
+}
+
+lambda_closures::lambda_closures(builder const& build)
+{
+    auto const n = impl::state_count(build);
+    std::vector<std::vector<std::size_t>> edges(n);
+
+    for(auto const& [state, transitions] : build.get_configuration()) {
+        for(auto const& transition : transitions) {
+            if(transition.on == lambda) {
+                edges[static_cast<std::size_t>(state)].push_back(
+                    static_cast<std::size_t>(transition.to));
+            }
+        }
+    }
+
+    struct frame
+    {
+        std::size_t state;
+        std::size_t edge;
+    };
+
+    constexpr std::size_t unvisited = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> index(n, unvisited);
+    std::vector<std::size_t> low(n, 0U);
+    std::vector<bool> on_stack(n, false);
+    std::vector<std::size_t> stack{};
+    std::vector<frame> call_stack{};
+    // closure of the component being closed, before it's sorted
+    std::vector<int> closure{};
+    std::size_t counter{ 0 };
+
+    m_component.assign(n, -1);
+    m_rows.reserve(n + 1U);
+    m_states.reserve(n);
+
+    auto visit = [&](std::size_t const state) -> void {
+        index[state] = low[state] = counter++;
+        stack.push_back(state);
+        on_stack[state] = true;
+        call_stack.push_back(frame{ state, 0U });
+    };
+
+    auto close_component = [&](std::size_t const root) -> void {
+        auto const component = m_rows.size() - 1U;
+        std::size_t member{ 0 };
+
+        closure.clear();
+
+        do {
+            member = stack.back();
+            stack.pop_back();
+            on_stack[member] = false;
+            m_component[member] = static_cast<int>(component);
+            closure.push_back(static_cast<int>(member));
+        } while(member != root);
+
+        // successor components are complete by now
+        auto const members = closure.size();
+        for(std::size_t i = 0; i < members; ++i) {
+            for(std::size_t const to :
+                edges[static_cast<std::size_t>(closure[i])]) {
+                auto const other = static_cast<std::size_t>(m_component[to]);
+
+                if(other != component) {
+                    auto const* const states = m_states.data();
+                    closure.insert(closure.end(),
+                                   states + m_rows[other],
+                                   states + m_rows[other + 1U]);
+                }
+            }
+        }
+
+        if(closure.size() > 1U) {
+            std::sort(closure.begin(), closure.end());
+            closure.erase(std::unique(closure.begin(), closure.end()),
+                          closure.end());
+        }
+
+        m_states.insert(m_states.end(), closure.begin(), closure.end());
+        m_rows.push_back(m_states.size());
+    };
+
+    for(std::size_t root = 0; root < n; ++root) {
+        if(index[root] != unvisited) {
+            continue;
+        }
+
+        visit(root);
+
+        while(!call_stack.empty()) {
+            auto& current = call_stack.back();
+            auto const state = current.state;
+
+            if(current.edge < edges[state].size()) {
+                auto const to = edges[state][current.edge++];
+
+                if(index[to] == unvisited) {
+                    visit(to);
+                }
+                else if(on_stack[to]) {
+                    low[state] = std::min(low[state], index[to]);
+                }
+
+                continue;
+            }
+
+            call_stack.pop_back();
+
+            if(!call_stack.empty()) {
+                auto const parent = call_stack.back().state;
+                low[parent] = std::min(low[parent], low[state]);
+            }
+            if(low[state] == index[state]) {
+                close_component(state);
+            }
+        }
+    }
+}
+
+auto lambda_closures::state_count() const noexcept -> std::size_t
+{
+    return m_component.size();
+}
+
+auto lambda_closures::component_count() const noexcept -> std::size_t
+{
+    return m_rows.size() - 1U;
+}
+
+auto lambda_closures::component_of(int const state) const -> int
+{
+    return m_component.at(static_cast<std::size_t>(state));
+}
+
+auto lambda_closures::of(int const state) const -> closure_range
+{
+    if(state < 0 || static_cast<std::size_t>(state) >= m_component.size()) {
+        throw std::out_of_range{ "State has no lambda closure" };
+    }
+
+    auto const component = static_cast<std::size_t>(
+        m_component[static_cast<std::size_t>(state)]);
+    auto const* const states = m_states.data();
+
+    return closure_range{ states + m_rows[component],
+                          states + m_rows[component + 1U] };
+}
+
+} // namespace fsm::impl
@@ -0,0 +1,109 @@
+#ifndef CLOSURE_HPP
+#define CLOSURE_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace fsm::impl {
+
+// Sorted states of one lambda closure, owned by the lambda_closures it comes
+// from
+class closure_range
+{
+private:
+    int const* m_first{ nullptr };
+    int const* m_last{ nullptr };
+
+public:
+    closure_range() = default;
+    closure_range(closure_range const&) = default;
+    closure_range(closure_range&&) noexcept = default;
+    ~closure_range() noexcept = default;
+
+    closure_range(int const* const first, int const* const last) noexcept;
+
+    auto operator=(closure_range const&) -> closure_range& = default;
+    auto operator=(closure_range&&) noexcept -> closure_range& = default;
+
+    [[nodiscard]] auto begin() const noexcept -> int const*;
+    [[nodiscard]] auto end() const noexcept -> int const*;
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+    [[nodiscard]] auto empty() const noexcept -> bool;
+};
+
+// Lambda closure of every state of a builder.
+//
+// The lambda graph is condensed with Tarjan's algorithm, so states on a lambda
+// cycle share a single closure, and each component's closure is merged once
+// from its successors (Tarjan emits components in reverse topological order).
+// Closures are stored back to back, so a state without lambda transitions
+// takes a single id and the whole takes the total size of the closures.
+class lambda_closures
+{
+private:
+    // state -> index of its strongly connected component
+    std::vector<int> m_component{};
+    // component -> first of its states in m_states, one past the last one
+    std::vector<std::size_t> m_rows{ 0U };
+    // the sorted closure of every component, one after the other
+    std::vector<int> m_states{};
+
+public:
+    lambda_closures() = default;
+    lambda_closures(lambda_closures const&) = default;
+    lambda_closures(lambda_closures&&) noexcept = default;
+    ~lambda_closures() noexcept = default;
+
+    explicit lambda_closures(builder const& build);
+
+    auto operator=(lambda_closures const&) -> lambda_closures& = default;
+    auto operator=(lambda_closures&&) noexcept -> lambda_closures& = default;
+
+    // States are numbered 0..state_count() - 1
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+    [[nodiscard]] auto component_count() const noexcept -> std::size_t;
+    [[nodiscard]] auto component_of(int const state) const -> int;
+    [[nodiscard]] auto of(int const state) const -> closure_range;
+};
+
+// Number of dense state ids a builder needs: 1 + the biggest id it mentions.
+//
+// Engines index vectors by state id, so this throws std::invalid_argument if
+// an id is negative, or if the ids are so sparse that the vectors would dwarf
+// the builder: the biggest id may be at most 4 per state the builder mentions
+// (its starting, accepting and transitions' states) plus 1024.
+[[nodiscard]] auto state_count(builder const& build) -> std::size_t;
+
+inline closure_range::closure_range(int const* const first,
+                                    int const* const last) noexcept
+    : m_first{ first }
+    , m_last{ last }
+{
+}
+
+inline auto closure_range::begin() const noexcept -> int const*
+{
+    return m_first;
+}
+
+inline auto closure_range::end() const noexcept -> int const*
+{
+    return m_last;
+}
+
+inline auto closure_range::size() const noexcept -> std::size_t
+{
+    return static_cast<std::size_t>(m_last - m_first);
+}
+
+inline auto closure_range::empty() const noexcept -> bool
+{
+    return m_first == m_last;
+}
+
+} // namespace fsm::impl
+
+#endif // !CLOSURE_HPP
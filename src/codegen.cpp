@@ -0,0 +1,91 @@
+#include "codegen.hpp"
+#include "dfa_table.hpp"
+
+namespace fsm {
+
+namespace {
+
+constexpr unsigned byte_max = 255U;
+
+auto write_state(impl::dfa_table const& table,
+                 int const state,
+                 std::ostream& out) -> void
+{
+    out << "state_" << state << ":\n";
+
+    if(table.accepts_all(state)) {
+        out << "    return true;\n";
+        return;
+    }
+
+    out << "    if(it == end) {\n"
+        << "        return " << (table.accepting(state) ? "true" : "false")
+        << ";\n"
+        << "    }\n"
+        << "    ch = static_cast<unsigned char>(*it++);\n";
+
+    for(auto const& range : table.ranges_of(state)) {
+        unsigned const low = range.low;
+        unsigned const high = range.high;
+
+        if(low == 0U && high == byte_max) {
+            out << "    goto state_" << range.to << ";\n";
+            continue;
+        }
+
+        if(low == high) {
+            out << "    if(ch == " << low << "U) {\n";
+        }
+        else if(low == 0U) {
+            out << "    if(ch <= " << high << "U) {\n";
+        }
+        else {
+            out << "    if(ch >= " << low << "U && ch <= " << high << "U) {\n";
+        }
+        out << "        goto state_" << range.to << ";\n"
+            << "    }\n";
+    }
+
+    out << "    return false;\n";
+}
+
+} // namespace
+
+auto write_matcher_header(std::string const& name, std::ostream& out) -> void
+{
+    out << "// Generated by lfa_generate, do not edit\n"
+        << "#pragma once\n\n"
+        << "#include <string_view>\n\n"
+        << "namespace fsm::generated {\n\n"
+        << "[[nodiscard]] auto " << name
+        << "(std::string_view input) noexcept -> bool;\n\n"
+        << "} // namespace fsm::generated\n";
+}
+
+auto write_matcher_source(dfa const& automaton,
+                          std::string const& name,
+                          std::ostream& out) -> void
+{
+    auto const& table = automaton.table();
+
+    out << "// Generated by lfa_generate, do not edit\n"
+        << "#include \"" << name << ".hpp\"\n\n"
+        << "namespace fsm::generated {\n\n"
+        << "auto " << name
+        << "(std::string_view const input) noexcept -> bool\n"
+        << "{\n"
+        << "    [[maybe_unused]] char const* it = input.data();\n"
+        << "    [[maybe_unused]] char const* const end = it + input.size();\n"
+        << "    [[maybe_unused]] unsigned ch{ 0U };\n\n"
+        << "    goto state_" << table.start() << ";\n\n";
+
+    for(int const state : table.reachable()) {
+        write_state(table, state, out);
+        out << '\n';
+    }
+
+    out << "}\n\n"
+        << "} // namespace fsm::generated\n";
+}
+
+} // namespace fsm
@@ -0,0 +1,23 @@
+#ifndef CODEGEN_HPP
+#define CODEGEN_HPP
+#pragma once
+
+#include "dfa.hpp"
+
+#include <ostream>
+#include <string>
+
+namespace fsm {
+
+// Direct-coded matchers: every DFA state becomes a label, its transitions
+// byte-range comparisons jumping to the next label. The generated function is
+// fsm::generated::<name>(std::string_view), declared in "<name>.hpp", and needs
+// only the standard library.
+auto write_matcher_header(std::string const& name, std::ostream& out) -> void;
+auto write_matcher_source(dfa const& automaton,
+                          std::string const& name,
+                          std::ostream& out) -> void;
+
+} // namespace fsm
+
+#endif // !CODEGEN_HPP
@@ -0,0 +1,174 @@
+#ifndef COMPACT_HPP
+#define COMPACT_HPP
+#pragma once
+
+#include "attributes.hpp"
+#include "dfa.hpp"
+#include "dfa_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace fsm {
+
+// The table of a DFA with state ids only as wide as StateId, so 2 to 4 times
+// more of it fits in cache. The largest StateId value stands for the dead
+// state, the other ones for states of the table, in the same order.
+template<typename StateId>
+class compact_dfa
+{
+    static_assert(std::is_unsigned_v<StateId>, "state ids are unsigned");
+
+public:
+    static constexpr StateId dead = std::numeric_limits<StateId>::max();
+    static constexpr std::size_t max_states = dead;
+
+private:
+    // byte -> equivalence class, the ones of the table
+    std::array<std::uint16_t, 256> m_classes{};
+    std::size_t m_class_count{ 1 };
+    // row-major: m_next[state * m_class_count + class]
+    std::vector<StateId> m_next{};
+    std::vector<std::uint8_t> m_attributes{};
+    StateId m_start{ dead };
+
+public:
+    compact_dfa() = delete;
+    compact_dfa(compact_dfa const&) = default;
+    compact_dfa(compact_dfa&&) noexcept = default;
+    ~compact_dfa() noexcept = default;
+
+    // Throws std::invalid_argument if the table has more than max_states
+    explicit compact_dfa(dfa const& automaton);
+
+    auto operator=(compact_dfa const&) -> compact_dfa& = default;
+    auto operator=(compact_dfa&&) noexcept -> compact_dfa& = default;
+
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+    // bytes of the transitions, classes and attributes
+    [[nodiscard]] auto memory_footprint() const noexcept -> std::size_t;
+
+    using run_state = StateId;
+
+    [[nodiscard]] auto initial() const noexcept -> run_state;
+    [[nodiscard]] auto step(run_state& state, char const input) const noexcept
+        -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& state) const noexcept
+        -> bool;
+};
+
+// Calls f with the compact_dfa of `automaton` whose ids are the narrowest of
+// std::uint8_t, std::uint16_t and std::uint32_t that fit its states, and
+// returns what f returns
+template<typename F>
+auto visit_compact(dfa const& automaton, F&& f) -> decltype(auto);
+
+template<typename StateId>
+compact_dfa<StateId>::compact_dfa(dfa const& automaton)
+{
+    constexpr std::size_t byte_count = 256U;
+    auto const& table = automaton.table();
+    auto const states = table.state_count();
+
+    if(states > max_states) {
+        throw std::invalid_argument{ std::to_string(states) +
+                                     " states don't fit in ids of " +
+                                     std::to_string(sizeof(StateId)) +
+                                     " bytes" };
+    }
+
+    m_class_count = table.class_count();
+
+    // a byte standing for every equivalence class
+    std::vector<char> representative(m_class_count, '\0');
+    for(std::size_t byte = 0; byte < byte_count; ++byte) {
+        auto const ch = static_cast<char>(static_cast<unsigned char>(byte));
+        auto const cls = table.class_of(ch);
+
+        m_classes[byte] = static_cast<std::uint16_t>(cls);
+        representative[cls] = ch;
+    }
+
+    auto const id = [](int const state) -> StateId {
+        return state == impl::dfa_table::dead ? dead
+                                              : static_cast<StateId>(state);
+    };
+
+    m_next.assign(states * m_class_count, dead);
+    m_attributes.resize(states, 0U);
+
+    for(std::size_t state = 0; state < states; ++state) {
+        auto const from = static_cast<int>(state);
+
+        m_attributes[state] = table.attributes(from);
+        for(std::size_t cls = 0; cls < m_class_count; ++cls) {
+            m_next[state * m_class_count + cls] =
+                id(table.step(from, representative[cls]));
+        }
+    }
+
+    m_start = id(table.start());
+}
+
+template<typename StateId>
+auto compact_dfa<StateId>::state_count() const noexcept -> std::size_t
+{
+    return m_attributes.size();
+}
+
+template<typename StateId>
+auto compact_dfa<StateId>::memory_footprint() const noexcept -> std::size_t
+{
+    return m_next.size() * sizeof(StateId) + sizeof(m_classes) +
+           m_attributes.size();
+}
+
+template<typename StateId>
+auto compact_dfa<StateId>::initial() const noexcept -> run_state
+{
+    return m_start;
+}
+
+template<typename StateId>
+auto compact_dfa<StateId>::step(run_state& state,
+                                char const input) const noexcept -> bool
+{
+    auto const row = static_cast<std::size_t>(state) * m_class_count;
+    state = m_next[row + m_classes[static_cast<unsigned char>(input)]];
+
+    return state != dead && (m_attributes[state] &
+                             impl::attribute::accept_all) == 0U;
+}
+
+template<typename StateId>
+auto compact_dfa<StateId>::is_accepting(run_state const& state) const noexcept
+    -> bool
+{
+    return state != dead &&
+           (m_attributes[state] & impl::attribute::accepting) != 0U;
+}
+
+template<typename F>
+auto visit_compact(dfa const& automaton, F&& f) -> decltype(auto)
+{
+    auto const states = automaton.table().state_count();
+
+    if(states <= compact_dfa<std::uint8_t>::max_states) {
+        return f(compact_dfa<std::uint8_t>{ automaton });
+    }
+    if(states <= compact_dfa<std::uint16_t>::max_states) {
+        return f(compact_dfa<std::uint16_t>{ automaton });
+    }
+
+    return f(compact_dfa<std::uint32_t>{ automaton });
+}
+
+} // namespace fsm
+
+#endif // !COMPACT_HPP
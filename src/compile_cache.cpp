@@ -0,0 +1,277 @@
+#include "compile_cache.hpp"
+#include "dfa.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "spec.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fsm {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char const* extension = ".lfa";
+constexpr char const* scratch_extension = ".tmp";
+// a writer takes milliseconds, a temporary this old was left by a dead one
+constexpr auto stale_after = std::chrono::minutes{ 10 };
+// between the source builder and the minimized one, a comment to read_spec
+constexpr std::string_view separator = "#minimized\n";
+
+[[nodiscard]] auto canonical(builder const& build) -> std::string
+{
+    std::ostringstream out{};
+    write_spec(out, build);
+
+    return out.str();
+}
+
+// FNV-1a
+[[nodiscard]] auto hash(std::string const& text) noexcept -> std::uint64_t
+{
+    std::uint64_t result{ 14695981039346656037ULL };
+
+    for(char const ch : text) {
+        result ^= static_cast<unsigned char>(ch);
+        result *= 1099511628211ULL;
+    }
+
+    return result;
+}
+
+[[nodiscard]] auto read_file(fs::path const& path) -> std::optional<std::string>
+{
+    std::ifstream in{ path, std::ios::binary };
+
+    if(!in) {
+        return std::nullopt;
+    }
+
+    std::ostringstream text{};
+    text << in.rdbuf();
+
+    if(in.bad()) {
+        return std::nullopt;
+    }
+
+    return text.str();
+}
+
+// Name no other writer picks, in the same directory so renaming is atomic
+[[nodiscard]] auto temporary(fs::path const& path) -> fs::path
+{
+    auto const thread =
+        std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto const nonce = std::random_device{}();
+
+    auto result = path;
+    result += '.' + std::to_string(thread) + '.' + std::to_string(nonce) +
+              scratch_extension;
+
+    return result;
+}
+
+} // namespace
+
+auto compile_minimized(builder const& build) -> builder
+{
+    lnfa with_lambdas{ build };
+    nfa without_lambdas{ with_lambdas.to_nfa() };
+    dfa const deterministic{ without_lambdas.to_dfa() };
+
+    return deterministic.minimize();
+}
+
+auto content_hash(builder const& build) -> std::uint64_t
+{
+    return hash(canonical(build));
+}
+
+compile_cache::compile_cache(std::filesystem::path directory,
+                             std::uintmax_t const max_bytes)
+    : m_directory{ std::move(directory) }
+    , m_max_bytes{ max_bytes }
+{
+    fs::create_directories(m_directory);
+}
+
+auto compile_cache::entry(std::uint64_t const key) const -> fs::path
+{
+    std::ostringstream name{};
+    name << std::hex << std::setw(16) << std::setfill('0') << key << extension;
+
+    return m_directory / name.str();
+}
+
+auto compile_cache::evict() const -> void
+{
+    std::error_code error{};
+    std::vector<std::tuple<fs::file_time_type, std::uintmax_t, fs::path>>
+        entries{};
+    std::uintmax_t total{ 0 };
+    auto const now = fs::file_time_type::clock::now();
+
+    for(fs::directory_iterator it{ m_directory, error }, end{};
+        !error && it != end;
+        it.increment(error)) {
+        auto const kind = it->path().extension();
+
+        if(kind != extension && kind != scratch_extension) {
+            continue;
+        }
+
+        // other processes may remove entries meanwhile
+        std::error_code gone{};
+        auto const time = it->last_write_time(gone);
+        auto const bytes = it->file_size(gone);
+
+        if(gone) {
+            continue;
+        }
+
+        if(kind == extension) {
+            entries.emplace_back(time, bytes, it->path());
+            total += bytes;
+        }
+        else if(now - time > stale_after) {
+            fs::remove(it->path(), gone);
+        }
+    }
+
+    std::sort(entries.begin(), entries.end());
+
+    for(auto const& [time, bytes, path] : entries) {
+        if(total <= m_max_bytes) {
+            break;
+        }
+
+        std::error_code gone{};
+        fs::remove(path, gone);
+        total -= bytes;
+    }
+}
+
+auto compile_cache::find(builder const& build) -> std::optional<builder>
+{
+    auto const source = canonical(build);
+    auto const path = this->entry(hash(source));
+    auto const text = read_file(path);
+
+    if(!text || text->compare(0, source.size(), source) != 0 ||
+       std::string_view{ *text }.substr(source.size(), separator.size()) !=
+           separator) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    std::istringstream minimized{ text->substr(source.size()) };
+    std::optional<builder> result{};
+
+    try {
+        result = read_spec(minimized);
+    }
+    catch(std::invalid_argument const&) {
+        std::error_code gone{};
+        fs::remove(path, gone);
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    // the least recently used entries go first
+    std::error_code untouched{};
+    fs::last_write_time(path, fs::file_time_type::clock::now(), untouched);
+
+    ++m_hits;
+    return result;
+}
+
+auto compile_cache::store(builder const& build, builder const& minimized)
+    -> bool
+{
+    auto const source = canonical(build);
+    auto const path = this->entry(hash(source));
+    auto const scratch = temporary(path);
+
+    {
+        std::ofstream out{ scratch, std::ios::binary | std::ios::trunc };
+        out << source << separator;
+        write_spec(out, minimized);
+
+        if(!out.flush()) {
+            std::error_code gone{};
+            fs::remove(scratch, gone);
+            return false;
+        }
+    }
+
+    std::error_code error{};
+    fs::rename(scratch, path, error);
+
+    if(error) {
+        std::error_code gone{};
+        fs::remove(scratch, gone);
+        return false;
+    }
+
+    this->evict();
+    return true;
+}
+
+auto compile_cache::minimized(builder const& build) -> builder
+{
+    if(auto cached = this->find(build)) {
+        return std::move(*cached);
+    }
+
+    auto result = compile_minimized(build);
+    this->store(build, result);
+
+    return result;
+}
+
+auto compile_cache::hits() const noexcept -> std::size_t
+{
+    return m_hits;
+}
+
+auto compile_cache::misses() const noexcept -> std::size_t
+{
+    return m_misses;
+}
+
+auto compile_cache::size() const -> std::uintmax_t
+{
+    std::error_code error{};
+    std::uintmax_t total{ 0 };
+
+    for(fs::directory_iterator it{ m_directory, error }, end{};
+        !error && it != end;
+        it.increment(error)) {
+        std::error_code gone{};
+        auto const bytes = it->file_size(gone);
+
+        auto const kind = it->path().extension();
+
+        if(!gone && (kind == extension || kind == scratch_extension)) {
+            total += bytes;
+        }
+    }
+
+    return total;
+}
+
+} // namespace fsm
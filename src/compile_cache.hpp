@@ -0,0 +1,77 @@
+#ifndef COMPILE_CACHE_HPP
+#define COMPILE_CACHE_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace fsm {
+
+// Minimized DFA of a (lambda-)NFA, through lnfa::to_nfa, nfa::to_dfa and
+// dfa::minimize
+[[nodiscard]] auto compile_minimized(builder const& build) -> builder;
+
+// Hash of the canonical content of `build`: its starting state, accepting
+// states and transitions, hence its alphabet too. Builders differing only in
+// the order they were built in hash the same.
+[[nodiscard]] auto content_hash(builder const& build) -> std::uint64_t;
+
+// Minimized DFAs kept on disk across runs and processes, one file per
+// builder named after its content hash.
+//
+// An entry holds the builder it was compiled from as well, so a hash
+// collision is a miss rather than a wrong automaton. Entries are written to a
+// temporary file renamed over the entry, so readers never see half an entry,
+// and the least recently used ones are removed once the entries take more than
+// `max_bytes`. Temporaries a dead writer left behind are removed along with
+// them. Entries that can't be read or written are recompiled: the cache only
+// ever saves time.
+class compile_cache
+{
+private:
+    std::filesystem::path m_directory{};
+    std::uintmax_t m_max_bytes{ 0 };
+    std::size_t m_hits{ 0 };
+    std::size_t m_misses{ 0 };
+
+    [[nodiscard]] auto entry(std::uint64_t const key) const
+        -> std::filesystem::path;
+    auto evict() const -> void;
+
+public:
+    static constexpr std::uintmax_t default_max_bytes = std::uintmax_t{ 64 }
+                                                        << 20U;
+
+    compile_cache() = delete;
+    compile_cache(compile_cache const&) = default;
+    compile_cache(compile_cache&&) noexcept = default;
+    ~compile_cache() noexcept = default;
+
+    // Creates `directory` if it doesn't exist, throws
+    // std::filesystem::filesystem_error if it can't
+    explicit compile_cache(std::filesystem::path directory,
+                           std::uintmax_t const max_bytes = default_max_bytes);
+
+    auto operator=(compile_cache const&) -> compile_cache& = default;
+    auto operator=(compile_cache&&) noexcept -> compile_cache& = default;
+
+    // compile_minimized(build), from the cache when it is there
+    [[nodiscard]] auto minimized(builder const& build) -> builder;
+    [[nodiscard]] auto find(builder const& build) -> std::optional<builder>;
+    // False if the entry couldn't be written
+    auto store(builder const& build, builder const& minimized) -> bool;
+
+    [[nodiscard]] auto hits() const noexcept -> std::size_t;
+    [[nodiscard]] auto misses() const noexcept -> std::size_t;
+    // bytes the entries and temporaries take on disk
+    [[nodiscard]] auto size() const -> std::uintmax_t;
+};
+
+} // namespace fsm
+
+#endif // !COMPILE_CACHE_HPP
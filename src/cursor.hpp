@@ -0,0 +1,108 @@
+#ifndef CURSOR_HPP
+#define CURSOR_HPP
+#pragma once
+
+#include "fsm.hpp"
+
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace fsm {
+
+// Compiled automaton that any number of cursors can match with at once. Its
+// kernel is const and keeps no state, so cursors on different threads need no
+// synchronization.
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+[[nodiscard]] auto share(Engine engine) -> std::shared_ptr<Engine const>
+{
+    return std::make_shared<Engine const>(std::move(engine));
+}
+
+// Matching position over a shared automaton: the engine's run state and not
+// much else, one per concurrent match
+template<typename Engine>
+class cursor
+{
+    static_assert(impl::is_engine_v<Engine>,
+                  "cursors walk engines with a matching kernel");
+
+private:
+    std::shared_ptr<Engine const> m_engine{};
+    typename Engine::run_state m_state{};
+    // the outcome can't change anymore
+    bool m_decided{ false };
+
+public:
+    cursor() = delete;
+    cursor(cursor const&) = default;
+    cursor(cursor&&) noexcept = default;
+    ~cursor() noexcept = default;
+
+    explicit cursor(std::shared_ptr<Engine const> engine);
+
+    auto operator=(cursor const&) -> cursor& = default;
+    auto operator=(cursor&&) noexcept -> cursor& = default;
+
+    auto next(char const input) -> void;
+    auto feed(std::string_view const input) -> void;
+    [[nodiscard]] auto aborted() const noexcept -> bool;
+    [[nodiscard]] auto accepted() const noexcept -> bool;
+    auto reset() -> void;
+
+    [[nodiscard]] auto engine() const noexcept -> Engine const&;
+};
+
+template<typename Engine>
+cursor<Engine>::cursor(std::shared_ptr<Engine const> engine)
+    : m_engine{ std::move(engine) }
+    , m_state{ m_engine->initial() }
+{
+}
+
+template<typename Engine>
+auto cursor<Engine>::next(char const input) -> void
+{
+    if(!m_decided) {
+        m_decided = !m_engine->step(m_state, input);
+    }
+}
+
+template<typename Engine>
+auto cursor<Engine>::feed(std::string_view const input) -> void
+{
+    for(auto it = input.begin(); it != input.end() && !m_decided; ++it) {
+        m_decided = !m_engine->step(m_state, *it);
+    }
+}
+
+template<typename Engine>
+auto cursor<Engine>::aborted() const noexcept -> bool
+{
+    return m_decided && !this->accepted();
+}
+
+template<typename Engine>
+auto cursor<Engine>::accepted() const noexcept -> bool
+{
+    return m_engine->is_accepting(m_state);
+}
+
+template<typename Engine>
+auto cursor<Engine>::reset() -> void
+{
+    m_state = m_engine->initial();
+    m_decided = false;
+}
+
+template<typename Engine>
+auto cursor<Engine>::engine() const noexcept -> Engine const&
+{
+    return *m_engine;
+}
+
+} // namespace fsm
+
+#endif // !CURSOR_HPP
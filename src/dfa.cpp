@@ -1,5 +1,7 @@
 #include "dfa.hpp"
+#include "nfa.hpp"
 #include "printer.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
 #include <deque>
@@ -9,30 +11,46 @@
 
 namespace fsm {
 
+dfa::compiled::compiled(builder&& source)
+    : build{ std::move(source) }
+    , table{ build }
+{
+}
+
+dfa::compiled::compiled(builder source, impl::dfa_table relaid_out)
+    : build{ std::move(source) }
+    , table{ std::move(relaid_out) }
+{
+}
+
+dfa::dfa(std::shared_ptr<compiled const> shared)
+    : m_compiled{ std::move(shared) }
+{
+    m_current_state = m_compiled->table.start();
+}
+
 dfa::dfa(builder const& build)
-    : m_builder{ build }
+    : m_compiled{ std::make_shared<compiled const>(builder{ build }) }
 {
-    m_current_state = m_builder.get_starting_state();
+    m_current_state = m_compiled->table.start();
 }
 
-dfa::dfa(builder&& build) noexcept
-    : m_builder{ std::move(build) }
+dfa::dfa(builder&& build)
+    : m_compiled{ std::make_shared<compiled const>(std::move(build)) }
 {
-    m_current_state = m_builder.get_starting_state();
+    m_current_state = m_compiled->table.start();
 }
 
 auto dfa::next(char const input) -> void
 {
-    auto const& autom = m_builder.get_configuration();
+    int const next_state = m_compiled->table.step(m_current_state, input);
 
-    for(auto const& transition : autom.at(m_current_state)) {
-        if(transition.on == input) {
-            m_current_state = transition.to;
-            return;
-        }
+    if(next_state == impl::dfa_table::dead) {
+        m_aborted = true;
+        return;
     }
 
-    m_aborted = true;
+    m_current_state = next_state;
 }
 
 auto dfa::aborted() const noexcept -> bool
@@ -42,10 +60,7 @@ auto dfa::aborted() const noexcept -> bool
 
 auto dfa::accepted() const noexcept -> bool
 {
-    auto const& accepting_states = m_builder.get_accepting_states();
-    auto const it = std::find(
-        accepting_states.begin(), accepting_states.end(), m_current_state);
-    return it != accepting_states.end();
+    return m_compiled->table.accepting(m_current_state);
 }
 
 auto dfa::accepts_lambda() noexcept -> bool
@@ -55,16 +70,16 @@ auto dfa::accepts_lambda() noexcept -> bool
 
 auto dfa::reset() -> void
 {
-    m_current_state = m_builder.get_starting_state();
+    m_current_state = m_compiled->table.start();
     m_aborted = false;
 }
 
 auto dfa::print_transitions() -> void
 {
-    auto const& autom = m_builder.get_configuration();
+    auto const& autom = m_compiled->build.get_configuration();
 
     std::cout << "Final states: [ ";
-    for(int const state : m_builder.get_accepting_states()) {
+    for(int const state : m_compiled->build.get_accepting_states()) {
         std::cout << state << ' ';
     }
     std::cout << "]" << std::endl;
@@ -101,11 +116,16 @@ auto dfa::get_reachable_from(int const state) const -> std::set<int>
 
     for(; !queue.empty(); queue.pop_front()) {
         int const current_state = queue.front();
-        auto const& autom = m_builder.get_configuration();
+        auto const& autom = m_compiled->build.get_configuration();
 
         reachable.insert(current_state);
 
-        for(auto const& transition : autom.at(current_state)) {
+        auto const it = autom.find(current_state);
+        if(it == autom.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
             insert(transition.to);
         }
     }
@@ -140,11 +160,15 @@ auto dfa::get_equivalent_states(
         }
     }
 
+    if(repr.empty()) {
+        return result;
+    }
+
     auto end_it = repr.end();
     std::advance(end_it, -1);
 
     auto is_final = [&](int const state) -> bool {
-        auto const& finals = m_builder.get_accepting_states();
+        auto const& finals = m_compiled->build.get_accepting_states();
 
         return std::find(finals.begin(), finals.end(), state) != finals.end();
     };
@@ -205,26 +229,35 @@ auto dfa::remove_equivalent(
 auto dfa::minimize() const -> builder
 {
     builder result{};
-    auto const& autom = m_builder.get_configuration();
+    auto const& autom = m_compiled->build.get_configuration();
     std::set<int> all_states{};
 
     for(auto const& [state, transitions] : autom) {
         all_states.insert(state);
     }
 
-    auto const unreachable_states =
-        all_states - this->get_reachable_from(m_builder.get_starting_state());
+    auto new_autom = autom;
+    std::set<int> reachable{};
 
-    /*
-    std::cout << "Unreachable: ";
-    print(unreachable_states);
-    std::cout << std::endl;
-    */
+    {
+        trace::scope phase{ trace::phase::unreachable_removal,
+                            all_states.size() };
 
-    auto new_autom = autom;
+        reachable =
+            this->get_reachable_from(m_compiled->build.get_starting_state());
+        auto const unreachable_states = all_states - reachable;
+
+        /*
+        std::cout << "Unreachable: ";
+        print(unreachable_states);
+        std::cout << std::endl;
+        */
 
-    for(int const state : unreachable_states) {
-        new_autom.erase(state);
+        for(int const state : unreachable_states) {
+            new_autom.erase(state);
+        }
+
+        phase.set_states_out(new_autom.size());
     }
 
     /*
@@ -236,23 +269,30 @@ auto dfa::minimize() const -> builder
     }
     */
 
-    auto equiv = this->get_equivalent_states(new_autom);
+    {
+        trace::scope phase{ trace::phase::equivalence_merging,
+                            new_autom.size() };
 
-    while(!equiv.empty()) {
-        /*
-        std::cout << "\nEquivalent states: ";
-        print(equiv);
-        std::cout << std::endl;
-        */
+        auto equiv = this->get_equivalent_states(new_autom);
+
+        while(!equiv.empty()) {
+            /*
+            std::cout << "\nEquivalent states: ";
+            print(equiv);
+            std::cout << std::endl;
+            */
 
-        new_autom = this->remove_equivalent(new_autom, equiv);
-        equiv = this->get_equivalent_states(new_autom);
+            new_autom = this->remove_equivalent(new_autom, equiv);
+            equiv = this->get_equivalent_states(new_autom);
+        }
+
+        phase.set_states_out(new_autom.size());
     }
 
-    result.set_starting_state(m_builder.get_starting_state());
+    result.set_starting_state(m_compiled->build.get_starting_state());
 
     auto is_final = [&](int const state) -> bool {
-        auto const& finals = m_builder.get_accepting_states();
+        auto const& finals = m_compiled->build.get_accepting_states();
 
         return std::find(finals.begin(), finals.end(), state) != finals.end();
     };
@@ -267,7 +307,36 @@ auto dfa::minimize() const -> builder
         }
     }
 
+    // final states without outgoing transitions are never merged
+    for(int const state : m_compiled->build.get_accepting_states()) {
+        if(autom.count(state) == 0U && reachable.count(state) > 0U) {
+            result.set_accepting_state(state);
+        }
+    }
+
     return result;
 }
 
+auto dfa::table() const noexcept -> impl::dfa_table const&
+{
+    return m_compiled->table;
+}
+
+auto dfa::reverse() const -> dfa
+{
+    nfa reversed{ m_compiled->build.reverse() };
+
+    return dfa{ reversed.to_dfa() };
+}
+
+auto dfa::with_layout(layout const strategy,
+                      std::string_view const sample) const -> dfa
+{
+    auto table = m_compiled->table;
+    table.renumber(impl::state_order(table, strategy, sample));
+
+    return dfa{ std::make_shared<compiled const>(m_compiled->build,
+                                                 std::move(table)) };
+}
+
 } // namespace fsm
@@ -2,18 +2,34 @@
 #define DFA_HPP
 #pragma once
 
+#include "dfa_table.hpp"
 #include "fsm.hpp"
 #include "fsm_builder.hpp"
+#include "layout.hpp"
 #include "transition.hpp"
 
+#include <memory>
 #include <set>
+#include <string_view>
 
 namespace fsm {
 
 class dfa final : public automaton
 {
 private:
-    builder m_builder{};
+    // Never changes after construction, shared by all the copies
+    class compiled
+    {
+    public:
+        builder build{};
+        impl::dfa_table table{};
+
+        explicit compiled(builder&& source);
+        compiled(builder source, impl::dfa_table relaid_out);
+    };
+
+    std::shared_ptr<compiled const> m_compiled{};
+    // dense state of the table
     int m_current_state{ 0 };
     bool m_aborted{ false };
 
@@ -27,6 +43,8 @@ private:
         std::set<int> const& equiv) const
         -> std::map<int, std::vector<fsm::impl::transition>>;
 
+    explicit dfa(std::shared_ptr<compiled const> shared);
+
 public:
     dfa() = delete;
     dfa(dfa const&) = default;
@@ -34,7 +52,7 @@ public:
     ~dfa() noexcept override = default;
 
     explicit dfa(builder const& build);
-    explicit dfa(builder&& build) noexcept;
+    explicit dfa(builder&& build);
 
     auto operator=(dfa const&) -> dfa& = default;
     auto operator=(dfa&&) noexcept -> dfa& = default;
@@ -47,8 +65,46 @@ public:
     auto print_transitions() -> void override;
 
     [[nodiscard]] auto minimize() const -> builder;
+    [[nodiscard]] auto table() const noexcept -> impl::dfa_table const&;
+    // DFA of the reversed language, by subset construction of the reversed
+    // automaton. Run on a text from right to left it finds where the matches
+    // ending at the position it started from begin.
+    [[nodiscard]] auto reverse() const -> dfa;
+    // Same automaton, the rows of its table reordered so the states used
+    // together share cache lines. `sample` is typical input, used by the
+    // strategies that profile.
+    [[nodiscard]] auto with_layout(layout const strategy,
+                                   std::string_view const sample = {}) const
+        -> dfa;
+
+    using run_state = int;
+
+    [[nodiscard]] auto initial() const noexcept -> run_state;
+    [[nodiscard]] auto step(run_state& state, char const input) const noexcept
+        -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& state) const noexcept
+        -> bool;
 };
 
+inline auto dfa::initial() const noexcept -> run_state
+{
+    return m_compiled->table.start();
+}
+
+inline auto dfa::step(run_state& state, char const input) const noexcept
+    -> bool
+{
+    auto const& table = m_compiled->table;
+
+    state = table.step(state, input);
+    return state != impl::dfa_table::dead && !table.accepts_all(state);
+}
+
+inline auto dfa::is_accepting(run_state const& state) const noexcept -> bool
+{
+    return state != impl::dfa_table::dead && m_compiled->table.accepting(state);
+}
+
 } // namespace fsm
 
 #endif // !DFA_HPP
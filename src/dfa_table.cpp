@@ -0,0 +1,303 @@
+#include "dfa_table.hpp"
+#include "lnfa.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace fsm::impl {
+
+dfa_table::dfa_table(builder const& build)
+{
+    auto const& autom = build.get_configuration();
+    std::map<int, int> dense{};
+
+    auto add_state = [&dense, this](int const state) -> void {
+        if(dense.count(state) > 0U) {
+            return;
+        }
+
+        dense[state] = static_cast<int>(m_ids.size());
+        m_ids.push_back(state);
+    };
+
+    add_state(build.get_starting_state());
+    for(auto const& [state, transitions] : autom) {
+        add_state(state);
+
+        for(auto const& transition : transitions) {
+            add_state(transition.to);
+        }
+    }
+
+    auto const state_count = m_ids.size();
+
+    // column of every character, the first transition wins like in dfa::next.
+    // There are no lambda transitions in a DFA, fsm::lambda is the byte 0.
+    auto alphabet = build.get_alphabet();
+    for(auto const& [state, transitions] : autom) {
+        for(auto const& transition : transitions) {
+            if(transition.on == lambda &&
+               alphabet.find(lambda) == std::string::npos) {
+                alphabet.insert(alphabet.begin(), lambda);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> columns(alphabet.size(),
+                                          std::vector<int>(state_count, dead));
+
+    for(auto const& [state, transitions] : autom) {
+        auto const from = static_cast<std::size_t>(dense.at(state));
+
+        for(auto const& transition : transitions) {
+            auto const ch = alphabet.find(transition.on);
+
+            if(ch == std::string::npos) {
+                continue;
+            }
+
+            auto& target = columns[ch][from];
+
+            if(target == dead) {
+                target = dense.at(transition.to);
+            }
+        }
+    }
+
+    // characters with identical columns are interchangeable, bytes outside of
+    // the alphabet stay in class 0 which never leads anywhere
+    std::map<std::vector<int>, std::uint16_t> classes{};
+    classes[std::vector<int>(state_count, dead)] = 0U;
+
+    for(std::size_t ch = 0; ch < alphabet.size(); ++ch) {
+        auto const [it, inserted] = classes.try_emplace(
+            columns[ch], static_cast<std::uint16_t>(classes.size()));
+        static_cast<void>(inserted);
+
+        m_classes[static_cast<unsigned char>(alphabet[ch])] = it->second;
+    }
+
+    m_class_count = classes.size();
+    m_next.assign(state_count * m_class_count, dead);
+
+    for(auto const& [column, cls] : classes) {
+        for(std::size_t state = 0; state < state_count; ++state) {
+            m_next[state * m_class_count + cls] = column[state];
+        }
+    }
+
+    m_attributes.assign(state_count, 0U);
+    for(int const state : build.get_accepting_states()) {
+        auto const it = dense.find(state);
+
+        if(it != dense.end()) {
+            m_attributes[static_cast<std::size_t>(it->second)] |=
+                attribute::accepting;
+        }
+    }
+
+    this->compute_attributes();
+
+    m_start = dense.at(build.get_starting_state());
+}
+
+auto dfa_table::compute_attributes() -> void
+{
+    auto const state_count = m_ids.size();
+    std::vector<std::vector<std::size_t>> reverse(state_count);
+
+    for(std::size_t state = 0; state < state_count; ++state) {
+        for(std::size_t cls = 0; cls < m_class_count; ++cls) {
+            int const to = m_next[state * m_class_count + cls];
+
+            if(to != dead) {
+                reverse[static_cast<std::size_t>(to)].push_back(state);
+            }
+        }
+    }
+
+    // co-reachability: walk the transitions backwards from accepting states
+    std::vector<bool> alive(state_count, false);
+    std::deque<std::size_t> queue{};
+
+    for(std::size_t state = 0; state < state_count; ++state) {
+        if((m_attributes[state] & attribute::accepting) != 0U) {
+            alive[state] = true;
+            queue.push_back(state);
+        }
+    }
+
+    for(; !queue.empty(); queue.pop_front()) {
+        for(std::size_t const from : reverse[queue.front()]) {
+            if(!alive[from]) {
+                alive[from] = true;
+                queue.push_back(from);
+            }
+        }
+    }
+
+    // accept-all is the greatest set of accepting states where every byte
+    // leads back into the set, only classes with bytes in them count
+    std::vector<bool> used(m_class_count, false);
+    for(auto const cls : m_classes) {
+        used[cls] = true;
+    }
+
+    std::vector<bool> accept_all(state_count, false);
+    for(std::size_t state = 0; state < state_count; ++state) {
+        accept_all[state] = (m_attributes[state] & attribute::accepting) != 0U;
+    }
+
+    for(bool changed = true; changed;) {
+        changed = false;
+
+        for(std::size_t state = 0; state < state_count; ++state) {
+            if(!accept_all[state]) {
+                continue;
+            }
+
+            for(std::size_t cls = 0; cls < m_class_count; ++cls) {
+                int const to = m_next[state * m_class_count + cls];
+
+                if(used[cls] &&
+                   (to == dead || !accept_all[static_cast<std::size_t>(to)])) {
+                    accept_all[state] = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for(std::size_t state = 0; state < state_count; ++state) {
+        if(!alive[state]) {
+            m_attributes[state] |= attribute::dead;
+        }
+        if(accept_all[state]) {
+            m_attributes[state] |= attribute::accept_all;
+        }
+    }
+
+    // going into a dead state stops matching right away
+    for(auto& to : m_next) {
+        if(to != dead &&
+           (m_attributes[static_cast<std::size_t>(to)] & attribute::dead) !=
+               0U) {
+            to = dead;
+        }
+    }
+}
+
+auto dfa_table::state_count() const noexcept -> std::size_t
+{
+    return m_ids.size();
+}
+
+auto dfa_table::class_count() const noexcept -> std::size_t
+{
+    return m_class_count;
+}
+
+auto dfa_table::id_of(int const state) const -> int
+{
+    return m_ids.at(static_cast<std::size_t>(state));
+}
+
+auto dfa_table::ranges_of(int const state) const -> std::vector<byte_range>
+{
+    constexpr unsigned byte_count = 256U;
+    std::vector<byte_range> result{};
+
+    for(unsigned low = 0; low < byte_count;) {
+        auto const byte = [](unsigned const value) -> char {
+            return static_cast<char>(static_cast<unsigned char>(value));
+        };
+
+        int const to = this->step(state, byte(low));
+        unsigned high = low;
+
+        while(high + 1U < byte_count &&
+              this->step(state, byte(high + 1U)) == to) {
+            ++high;
+        }
+
+        if(to != dead) {
+            result.push_back(byte_range{ static_cast<unsigned char>(low),
+                                         static_cast<unsigned char>(high),
+                                         to });
+        }
+
+        low = high + 1U;
+    }
+
+    return result;
+}
+
+auto dfa_table::reachable() const -> std::vector<int>
+{
+    std::vector<int> result{};
+    std::vector<bool> seen(this->state_count(), false);
+    std::deque<int> queue{ m_start };
+
+    seen[static_cast<std::size_t>(m_start)] = true;
+
+    for(; !queue.empty(); queue.pop_front()) {
+        int const state = queue.front();
+        result.push_back(state);
+
+        if(this->accepts_all(state)) {
+            continue;
+        }
+
+        for(auto const& range : this->ranges_of(state)) {
+            if(!seen[static_cast<std::size_t>(range.to)]) {
+                seen[static_cast<std::size_t>(range.to)] = true;
+                queue.push_back(range.to);
+            }
+        }
+    }
+
+    return result;
+}
+
+auto dfa_table::renumber(std::vector<int> const& order) -> void
+{
+    auto const state_count = m_ids.size();
+    std::vector<int> new_id(state_count, dead);
+
+    for(std::size_t i = 0; i < order.size(); ++i) {
+        new_id.at(static_cast<std::size_t>(order[i])) = static_cast<int>(i);
+    }
+    if(order.size() != state_count ||
+       std::find(new_id.begin(), new_id.end(), dead) != new_id.end()) {
+        throw std::invalid_argument{ "renumbering needs every state once" };
+    }
+
+    std::vector<int> next(m_next.size(), dead);
+    std::vector<std::uint8_t> attributes(state_count, 0U);
+    std::vector<int> ids(state_count, 0);
+
+    for(std::size_t i = 0; i < state_count; ++i) {
+        auto const old_state = static_cast<std::size_t>(order[i]);
+
+        for(std::size_t cls = 0; cls < m_class_count; ++cls) {
+            int const to = m_next[old_state * m_class_count + cls];
+
+            next[i * m_class_count + cls] =
+                to == dead ? dead : new_id[static_cast<std::size_t>(to)];
+        }
+
+        attributes[i] = m_attributes[old_state];
+        ids[i] = m_ids[old_state];
+    }
+
+    m_next.swap(next);
+    m_attributes.swap(attributes);
+    m_ids.swap(ids);
+    m_start = new_id[static_cast<std::size_t>(m_start)];
+}
+
+} // namespace fsm::impl
@@ -0,0 +1,131 @@
+#ifndef DFA_TABLE_HPP
+#define DFA_TABLE_HPP
+#pragma once
+
+#include "attributes.hpp"
+#include "bits.hpp"
+#include "fsm_builder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fsm::impl {
+
+// Bytes low..high, all going to the same state
+class byte_range
+{
+public:
+    unsigned char low{ 0U };
+    unsigned char high{ 0U };
+    int to{ -1 };
+};
+
+// Dense transition table of a deterministic builder.
+//
+// States are renumbered 0..state_count() - 1 and bytes with identical columns
+// share one equivalence class, so a step is a single table lookup. Transitions
+// into states that can't reach an accepting state lead straight to `dead`.
+class dfa_table
+{
+public:
+    static constexpr int dead = -1;
+
+private:
+    // byte -> equivalence class, class 0 has no transitions at all
+    std::array<std::uint16_t, 256> m_classes{};
+    std::size_t m_class_count{ 1 };
+    // row-major: m_next[state * m_class_count + class]
+    std::vector<int> m_next{};
+    // impl::attribute flags of every state
+    std::vector<std::uint8_t> m_attributes{};
+    // dense state -> state of the builder
+    std::vector<int> m_ids{};
+    int m_start{ dead };
+
+    auto compute_attributes() -> void;
+
+public:
+    dfa_table() = default;
+    dfa_table(dfa_table const&) = default;
+    dfa_table(dfa_table&&) noexcept = default;
+    ~dfa_table() noexcept = default;
+
+    explicit dfa_table(builder const& build);
+
+    auto operator=(dfa_table const&) -> dfa_table& = default;
+    auto operator=(dfa_table&&) noexcept -> dfa_table& = default;
+
+    [[nodiscard]] auto start() const noexcept -> int;
+    [[nodiscard]] auto step(int const state, char const input) const noexcept
+        -> int;
+    // Starts loading the transition step(state, input) will read
+    auto prefetch(int const state, char const input) const noexcept -> void;
+    [[nodiscard]] auto accepting(int const state) const noexcept -> bool;
+    [[nodiscard]] auto accepts_all(int const state) const noexcept -> bool;
+    [[nodiscard]] auto attributes(int const state) const noexcept
+        -> std::uint8_t;
+
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+    [[nodiscard]] auto class_count() const noexcept -> std::size_t;
+    [[nodiscard]] auto class_of(char const input) const noexcept
+        -> std::size_t;
+    [[nodiscard]] auto id_of(int const state) const -> int;
+
+    // Transitions of `state` as maximal runs of bytes going to the same state,
+    // without the ones going nowhere
+    [[nodiscard]] auto ranges_of(int const state) const
+        -> std::vector<byte_range>;
+    // States matching can go through, breadth first from the start. Matching
+    // stops at accept-all states so what comes after them isn't included.
+    [[nodiscard]] auto reachable() const -> std::vector<int>;
+
+    // Moves state order[i] to i, `order` holds every state once
+    auto renumber(std::vector<int> const& order) -> void;
+};
+
+inline auto dfa_table::start() const noexcept -> int
+{
+    return m_start;
+}
+
+inline auto dfa_table::step(int const state, char const input) const noexcept
+    -> int
+{
+    auto const row = static_cast<std::size_t>(state) * m_class_count;
+    return m_next[row + this->class_of(input)];
+}
+
+inline auto dfa_table::prefetch(int const state,
+                                char const input) const noexcept -> void
+{
+    auto const row = static_cast<std::size_t>(state) * m_class_count;
+    impl::prefetch(&m_next[row + this->class_of(input)]);
+}
+
+inline auto dfa_table::accepting(int const state) const noexcept -> bool
+{
+    return (this->attributes(state) & attribute::accepting) != 0U;
+}
+
+inline auto dfa_table::accepts_all(int const state) const noexcept -> bool
+{
+    return (this->attributes(state) & attribute::accept_all) != 0U;
+}
+
+inline auto dfa_table::attributes(int const state) const noexcept
+    -> std::uint8_t
+{
+    return m_attributes[static_cast<std::size_t>(state)];
+}
+
+inline auto dfa_table::class_of(char const input) const noexcept
+    -> std::size_t
+{
+    return m_classes[static_cast<unsigned char>(input)];
+}
+
+} // namespace fsm::impl
+
+#endif // !DFA_TABLE_HPP
@@ -0,0 +1,371 @@
+#include "equivalence.hpp"
+#include "closure.hpp"
+#include "lnfa.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fsm {
+
+namespace {
+
+constexpr int dead = impl::dfa_table::dead;
+constexpr std::size_t byte_count = 256U;
+constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+// Step of a table where `dead` is a state like the others
+[[nodiscard]] auto step(impl::dfa_table const& table,
+                        int const state,
+                        char const input) noexcept -> int
+{
+    return state == dead ? dead : table.step(state, input);
+}
+
+[[nodiscard]] auto accepting(impl::dfa_table const& table,
+                             int const state) noexcept -> bool
+{
+    return state != dead && table.accepting(state);
+}
+
+// One byte for each pair of classes the two tables put it in
+[[nodiscard]] auto product_alphabet(impl::dfa_table const& a,
+                                    impl::dfa_table const& b)
+    -> std::vector<char>
+{
+    std::vector<bool> seen(a.class_count() * b.class_count(), false);
+    std::vector<char> result{};
+
+    for(std::size_t byte = 0; byte < byte_count; ++byte) {
+        auto const ch = static_cast<char>(static_cast<unsigned char>(byte));
+        auto const pair = a.class_of(ch) * b.class_count() + b.class_of(ch);
+
+        if(!seen[pair]) {
+            seen[pair] = true;
+            result.push_back(ch);
+        }
+    }
+
+    return result;
+}
+
+class disjoint_sets
+{
+private:
+    std::vector<std::size_t> m_parent{};
+
+public:
+    disjoint_sets() = delete;
+    disjoint_sets(disjoint_sets const&) = default;
+    disjoint_sets(disjoint_sets&&) noexcept = default;
+    ~disjoint_sets() noexcept = default;
+
+    explicit disjoint_sets(std::size_t const size)
+        : m_parent(size)
+    {
+        std::iota(m_parent.begin(), m_parent.end(), std::size_t{ 0 });
+    }
+
+    auto operator=(disjoint_sets const&) -> disjoint_sets& = default;
+    auto operator=(disjoint_sets&&) noexcept -> disjoint_sets& = default;
+
+    [[nodiscard]] auto find(std::size_t element) -> std::size_t
+    {
+        while(m_parent[element] != element) {
+            m_parent[element] = m_parent[m_parent[element]];
+            element = m_parent[element];
+        }
+
+        return element;
+    }
+
+    // false if they already were in the same set
+    auto merge(std::size_t const x, std::size_t const y) -> bool
+    {
+        auto const root_x = this->find(x);
+        auto const root_y = this->find(y);
+
+        if(root_x == root_y) {
+            return false;
+        }
+
+        m_parent[root_y] = root_x;
+        return true;
+    }
+};
+
+// Node of a breadth-first search, the path to it is read back through `parent`
+class visit
+{
+public:
+    std::size_t parent{ none };
+    char input{ '\0' };
+};
+
+[[nodiscard]] auto word_to(std::vector<visit> const& visits,
+                           std::size_t node) -> std::string
+{
+    std::string result{};
+
+    for(; visits[node].parent != none; node = visits[node].parent) {
+        result.push_back(visits[node].input);
+    }
+
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+// Plain breadth-first search of the product for a pair of states that disagree
+[[nodiscard]] auto shortest_difference(impl::dfa_table const& a,
+                                       impl::dfa_table const& b,
+                                       std::vector<char> const& alphabet)
+    -> std::string
+{
+    // `dead` is stored as state_count()
+    auto const width = b.state_count() + 1U;
+    auto index = [&](int const x, int const y) -> std::size_t {
+        auto const i =
+            x == dead ? a.state_count() : static_cast<std::size_t>(x);
+        auto const j =
+            y == dead ? b.state_count() : static_cast<std::size_t>(y);
+        return i * width + j;
+    };
+
+    std::vector<bool> seen((a.state_count() + 1U) * width, false);
+    std::vector<visit> visits{ visit{} };
+    std::deque<std::pair<std::pair<int, int>, std::size_t>> queue{
+        { { a.start(), b.start() }, 0U }
+    };
+    seen[index(a.start(), b.start())] = true;
+
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const [states, node] = queue.front();
+        auto const [x, y] = states;
+
+        if(accepting(a, x) != accepting(b, y)) {
+            return word_to(visits, node);
+        }
+
+        for(char const ch : alphabet) {
+            int const next_x = step(a, x, ch);
+            int const next_y = step(b, y, ch);
+            auto const i = index(next_x, next_y);
+
+            if(!seen[i]) {
+                seen[i] = true;
+                visits.push_back(visit{ node, ch });
+                queue.push_back({ { next_x, next_y }, visits.size() - 1U });
+            }
+        }
+    }
+
+    return {};
+}
+
+// Sorted states reached from `subset` on `ch`, lambda closure included
+[[nodiscard]] auto successors(builder const& build,
+                              impl::lambda_closures const& closures,
+                              std::vector<int> const& subset,
+                              char const ch) -> std::vector<int>
+{
+    auto const& autom = build.get_configuration();
+    std::vector<int> result{};
+
+    for(int const state : subset) {
+        auto const it = autom.find(state);
+
+        if(it == autom.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
+            if(transition.on == ch) {
+                auto const reached = closures.of(transition.to);
+                result.insert(result.end(), reached.begin(), reached.end());
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+[[nodiscard]] auto is_accepting(builder const& build, int const state) -> bool
+{
+    auto const& accepting_states = build.get_accepting_states();
+
+    return std::find(accepting_states.begin(),
+                     accepting_states.end(),
+                     state) != accepting_states.end();
+}
+
+[[nodiscard]] auto any_accepting(builder const& build,
+                                 std::vector<int> const& subset) -> bool
+{
+    return std::any_of(subset.begin(), subset.end(), [&](int const state) {
+        return is_accepting(build, state);
+    });
+}
+
+// Shortest string accepted by `a` but not by `b`, if any
+[[nodiscard]] auto not_included(builder const& a,
+                                impl::lambda_closures const& closures_a,
+                                builder const& b,
+                                impl::lambda_closures const& closures_b,
+                                std::string const& alphabet)
+    -> std::optional<std::string>
+{
+    class pair
+    {
+    public:
+        int state{ 0 };
+        std::vector<int> subset{};
+    };
+
+    std::vector<pair> pairs{};
+    std::vector<visit> visits{};
+    // state of `a` -> indices in `pairs` of the minimal subsets seen with it
+    std::map<int, std::vector<std::size_t>> antichain{};
+    std::deque<std::size_t> queue{};
+
+    auto add = [&](int const state, std::vector<int> subset, visit from) {
+        auto& minimal = antichain[state];
+
+        for(std::size_t const i : minimal) {
+            if(std::includes(subset.begin(),
+                             subset.end(),
+                             pairs[i].subset.begin(),
+                             pairs[i].subset.end())) {
+                return;
+            }
+        }
+
+        // bigger subsets already queued are still explored, they were found
+        // with shorter strings
+        auto const removed =
+            std::remove_if(minimal.begin(), minimal.end(), [&](auto const i) {
+                return std::includes(pairs[i].subset.begin(),
+                                     pairs[i].subset.end(),
+                                     subset.begin(),
+                                     subset.end());
+            });
+        minimal.erase(removed, minimal.end());
+
+        minimal.push_back(pairs.size());
+        queue.push_back(pairs.size());
+        pairs.push_back(pair{ state, std::move(subset) });
+        visits.push_back(from);
+    };
+
+    auto const closure_b = closures_b.of(b.get_starting_state());
+    std::vector<int> const start_b(closure_b.begin(), closure_b.end());
+    for(int const state : closures_a.of(a.get_starting_state())) {
+        add(state, start_b, visit{});
+    }
+
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const current = queue.front();
+        int const state = pairs[current].state;
+        auto const subset = pairs[current].subset;
+
+        if(is_accepting(a, state) &&
+           !any_accepting(b, subset)) {
+            return word_to(visits, current);
+        }
+
+        for(char const ch : alphabet) {
+            auto const next_subset = successors(b, closures_b, subset, ch);
+
+            for(int const next : successors(a, closures_a, { state }, ch)) {
+                add(next, next_subset, visit{ current, ch });
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+auto equivalent(dfa const& a, dfa const& b) -> equivalence
+{
+    auto const& table_a = a.table();
+    auto const& table_b = b.table();
+    auto const alphabet = product_alphabet(table_a, table_b);
+
+    // states of `a`, its dead state, then the same for `b`
+    auto const offset = table_a.state_count() + 1U;
+    auto element = [&](int const state, bool const of_b) -> std::size_t {
+        if(of_b) {
+            return offset + (state == dead ? table_b.state_count()
+                                           : static_cast<std::size_t>(state));
+        }
+        return state == dead ? table_a.state_count()
+                             : static_cast<std::size_t>(state);
+    };
+
+    disjoint_sets sets{ offset + table_b.state_count() + 1U };
+    std::deque<std::pair<int, int>> queue{};
+
+    if(sets.merge(element(table_a.start(), false),
+                  element(table_b.start(), true))) {
+        queue.emplace_back(table_a.start(), table_b.start());
+    }
+
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const [x, y] = queue.front();
+
+        if(accepting(table_a, x) != accepting(table_b, y)) {
+            return equivalence{
+                false, shortest_difference(table_a, table_b, alphabet)
+            };
+        }
+
+        for(char const ch : alphabet) {
+            int const next_x = step(table_a, x, ch);
+            int const next_y = step(table_b, y, ch);
+
+            if(sets.merge(element(next_x, false), element(next_y, true))) {
+                queue.emplace_back(next_x, next_y);
+            }
+        }
+    }
+
+    return equivalence{};
+}
+
+auto equivalent(builder const& a, builder const& b) -> equivalence
+{
+    impl::lambda_closures const closures_a{ a };
+    impl::lambda_closures const closures_b{ b };
+
+    std::string alphabet = a.get_alphabet() + b.get_alphabet();
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()),
+                   alphabet.end());
+    alphabet.erase(std::remove(alphabet.begin(), alphabet.end(), lambda),
+                   alphabet.end());
+
+    auto const only_a = not_included(a, closures_a, b, closures_b, alphabet);
+    auto const only_b = not_included(b, closures_b, a, closures_a, alphabet);
+
+    if(!only_a.has_value() && !only_b.has_value()) {
+        return equivalence{};
+    }
+    if(!only_b.has_value() ||
+       (only_a.has_value() && only_a->size() <= only_b->size())) {
+        return equivalence{ false, *only_a };
+    }
+
+    return equivalence{ false, *only_b };
+}
+
+} // namespace fsm
@@ -0,0 +1,38 @@
+#ifndef EQUIVALENCE_HPP
+#define EQUIVALENCE_HPP
+#pragma once
+
+#include "dfa.hpp"
+#include "fsm_builder.hpp"
+
+#include <string>
+
+namespace fsm {
+
+class equivalence
+{
+public:
+    bool equal{ true };
+    // A shortest string accepted by exactly one of the two automata, empty
+    // when they are equal
+    std::string counterexample{};
+};
+
+// Hopcroft and Karp's check: the product of the two DFAs is explored breadth
+// first and the pairs of states that must be equivalent are merged with
+// union-find, which stops the exploration after at most
+// a.state_count() + b.state_count() merges. Only when the languages differ is
+// the product explored without merging, to find a shortest counterexample.
+[[nodiscard]] auto equivalent(dfa const& a, dfa const& b) -> equivalence;
+
+// Same question for (lambda-)NFAs, without determinizing them: inclusion is
+// checked both ways over pairs (state of one automaton, subset of the other)
+// and a pair is dropped as soon as one with a smaller subset was seen, only
+// the antichain of the minimal ones is kept. Transitions on fsm::lambda are
+// lambda transitions.
+[[nodiscard]] auto equivalent(builder const& a, builder const& b)
+    -> equivalence;
+
+} // namespace fsm
+
+#endif // !EQUIVALENCE_HPP
@@ -4,7 +4,7 @@
 
 namespace fsm {
 
-auto accepts(automaton& autom, std::string const& input) -> bool
+auto accepts(automaton& autom, std::string_view const input) -> bool
 {
     if(input.empty()) {
         return autom.accepts_lambda();
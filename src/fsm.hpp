@@ -2,7 +2,14 @@
 #define FSM_HPP
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace fsm {
 
@@ -25,7 +32,238 @@ public:
     virtual auto print_transitions() -> void = 0;
 };
 
-[[nodiscard]] auto accepts(automaton& autom, std::string const& input) -> bool;
+// Polymorphic matching, one virtual call per character
+[[nodiscard]] auto accepts(automaton& autom, std::string_view const input)
+    -> bool;
+
+namespace impl {
+
+// An engine exposes a non-virtual matching kernel:
+//  - run_state: everything that changes while matching
+//  - initial(): run state before reading anything
+//  - step(state, input): advances the run state, false once the outcome can't
+//    change anymore (nothing is active, or every suffix is accepted)
+//  - is_accepting(state)
+template<typename Engine, typename = void>
+struct is_engine : std::false_type
+{
+};
+
+template<typename Engine>
+struct is_engine<
+    Engine,
+    std::void_t<typename Engine::run_state,
+                decltype(std::declval<Engine const&>().initial()),
+                decltype(std::declval<Engine const&>().step(
+                    std::declval<typename Engine::run_state&>(), char{})),
+                decltype(std::declval<Engine const&>().is_accepting(
+                    std::declval<typename Engine::run_state const&>()))>>
+    : std::true_type
+{
+};
+
+template<typename Engine>
+inline constexpr bool is_engine_v = is_engine<Engine>::value;
+
+} // namespace impl
+
+// Static dispatch: the whole loop is instantiated for the concrete engine, it
+// doesn't touch the engine's own run state so it can be shared between threads
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+[[nodiscard]] auto accepts(Engine const& engine, std::string_view const input)
+    -> bool
+{
+    auto state = engine.initial();
+
+    for(char const tok : input) {
+        if(!engine.step(state, tok)) {
+            break;
+        }
+    }
+
+    return engine.is_accepting(state);
+}
+
+class prefix_match
+{
+public:
+    // number of characters read before the automaton got stuck
+    std::size_t consumed{ 0 };
+    // end offset of the longest accepted prefix
+    std::optional<std::size_t> longest{};
+};
+
+// Single pass, stops as soon as the outcome is decided
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+[[nodiscard]] auto match_prefix(Engine const& engine,
+                                std::string_view const input) -> prefix_match
+{
+    prefix_match result{};
+    auto state = engine.initial();
+
+    if(engine.is_accepting(state)) {
+        result.longest = 0U;
+    }
+
+    for(std::size_t i = 0; i < input.size(); ++i) {
+        if(!engine.step(state, input[i])) {
+            if(engine.is_accepting(state)) {
+                // every longer prefix is accepted as well
+                result.consumed = input.size();
+                result.longest = input.size();
+            }
+            else {
+                result.consumed = i;
+            }
+            return result;
+        }
+        if(engine.is_accepting(state)) {
+            result.longest = i + 1U;
+        }
+    }
+
+    result.consumed = input.size();
+    return result;
+}
+
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+[[nodiscard]] auto longest_match(Engine const& engine,
+                                 std::string_view const input)
+    -> std::optional<std::size_t>
+{
+    return match_prefix(engine, input).longest;
+}
+
+namespace impl {
+
+// Single pass over `input` calling on_accept(end) for each accepted prefix.
+// Once every suffix is accepted, on_accept_rest(first) stands for all the ends
+// from `first` to input.size().
+template<typename Engine, typename OnAccept, typename OnAcceptRest>
+auto walk_accepting_prefixes(Engine const& engine,
+                             std::string_view const input,
+                             OnAccept&& on_accept,
+                             OnAcceptRest&& on_accept_rest) -> void
+{
+    auto state = engine.initial();
+
+    if(engine.is_accepting(state)) {
+        on_accept(std::size_t{ 0 });
+    }
+
+    for(std::size_t i = 0; i < input.size(); ++i) {
+        bool const undecided = engine.step(state, input[i]);
+        bool const accepting = engine.is_accepting(state);
+
+        if(!undecided) {
+            if(accepting) {
+                on_accept_rest(i + 1U);
+            }
+            return;
+        }
+        if(accepting) {
+            on_accept(i + 1U);
+        }
+    }
+}
+
+} // namespace impl
+
+// Calls on_accept(end) for the end offset of every accepted prefix, from 0 to
+// input.size() in increasing order, reading the input once and allocating
+// nothing
+template<typename Engine,
+         typename OnAccept,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+auto for_each_accepting_prefix(Engine const& engine,
+                               std::string_view const input,
+                               OnAccept&& on_accept) -> void
+{
+    impl::walk_accepting_prefixes(
+        engine, input, on_accept, [&](std::size_t const first) {
+            for(std::size_t end = first; end <= input.size(); ++end) {
+                on_accept(end);
+            }
+        });
+}
+
+// Writes the end offsets of the accepted prefixes to out[0..capacity) and
+// returns how many prefixes are accepted, which is more than `capacity` when
+// some didn't fit
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+auto accepting_prefixes(Engine const& engine,
+                        std::string_view const input,
+                        std::size_t* const out,
+                        std::size_t const capacity) -> std::size_t
+{
+    std::size_t count{ 0 };
+
+    impl::walk_accepting_prefixes(
+        engine,
+        input,
+        [&](std::size_t const end) {
+            if(count < capacity) {
+                out[count] = end;
+            }
+            ++count;
+        },
+        [&](std::size_t const first) {
+            for(std::size_t end = first; end <= input.size(); ++end) {
+                if(count < capacity) {
+                    out[count] = end;
+                }
+                ++count;
+            }
+        });
+
+    return count;
+}
+
+// Sets bit `end` of the bitmap for every accepted prefix and clears the others.
+// The bitmap holds input.size() + 1 bits, 64 per word starting from the least
+// significant one. Returns how many prefixes are accepted.
+template<typename Engine,
+         typename = std::enable_if_t<impl::is_engine_v<Engine>>>
+auto mark_accepting_prefixes(Engine const& engine,
+                             std::string_view const input,
+                             std::uint64_t* const bitmap) -> std::size_t
+{
+    constexpr std::size_t bits = 64U;
+    auto const last = input.size();
+    std::size_t count{ 0 };
+
+    for(std::size_t word = 0; word <= last / bits; ++word) {
+        bitmap[word] = 0U;
+    }
+
+    impl::walk_accepting_prefixes(
+        engine,
+        input,
+        [&](std::size_t const end) {
+            bitmap[end / bits] |= std::uint64_t{ 1U } << (end % bits);
+            ++count;
+        },
+        [&](std::size_t const first) {
+            // whole words at once
+            for(std::size_t end = first; end <= last;) {
+                auto const offset = end % bits;
+                auto const span = std::min(bits - offset, last - end + 1U);
+                auto const ones = span == bits
+                                      ? ~std::uint64_t{ 0U }
+                                      : (std::uint64_t{ 1U } << span) - 1U;
+
+                bitmap[end / bits] |= ones << offset;
+                end += span;
+            }
+            count += last - first + 1U;
+        });
+
+    return count;
+}
 
 } // namespace fsm
 
@@ -52,4 +52,53 @@ auto builder::get_alphabet() const noexcept -> std::string
     return m_alphabet;
 }
 
+auto builder::reverse() const -> builder
+{
+    builder result{};
+    int fresh{ m_starting_state };
+
+    for(auto const& [from, transitions] : m_automaton) {
+        fresh = std::max(fresh, from);
+
+        for(auto const& transition : transitions) {
+            result.add_transition(transition.to, transition.on, from);
+            fresh = std::max(fresh, transition.to);
+        }
+    }
+
+    result.set_accepting_state(m_starting_state);
+
+    std::vector<int> starts{ m_accepting_states };
+    std::sort(starts.begin(), starts.end());
+    starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+    if(starts.size() == 1U) {
+        result.set_starting_state(starts.front());
+        return result;
+    }
+
+    for(int const state : starts) {
+        fresh = std::max(fresh, state);
+    }
+    ++fresh;
+    result.set_starting_state(fresh);
+
+    for(int const state : starts) {
+        if(state == m_starting_state) {
+            result.set_accepting_state(fresh);
+        }
+
+        auto const it = result.m_automaton.find(state);
+        if(it == result.m_automaton.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
+            result.add_transition(fresh, transition.on, transition.to);
+        }
+    }
+
+    return result;
+}
+
 } // namespace fsm
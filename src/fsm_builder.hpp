@@ -39,6 +39,12 @@ public:
         -> std::vector<int> const&;
     [[nodiscard]] auto get_starting_state() const noexcept -> int;
     [[nodiscard]] auto get_alphabet() const noexcept -> std::string;
+
+    // Automaton of the reversed language: every transition turned around,
+    // starting from the accepting states and accepting at the start. With
+    // several accepting states a new starting state takes the transitions of
+    // all of them, so no lambda transition is added.
+    [[nodiscard]] auto reverse() const -> builder;
 };
 
 } // namespace fsm
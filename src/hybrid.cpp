@@ -0,0 +1,452 @@
+#include "hybrid.hpp"
+#include "attributes.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace fsm {
+
+namespace {
+
+constexpr int dead = impl::dfa_table::dead;
+// bookkeeping of a DFA state on top of its row and its subset
+constexpr std::size_t state_overhead = 64U;
+
+// Bytes a DFA state takes: its row, and its subset both as key and as value
+[[nodiscard]] auto cost(std::size_t const class_count,
+                        std::size_t const subset_size) noexcept -> std::size_t
+{
+    return (class_count + 2U * subset_size) * sizeof(int) + state_overhead;
+}
+
+[[nodiscard]] auto is_dead(std::vector<std::uint8_t> const& attributes,
+                           int const state) -> bool
+{
+    return (attributes[static_cast<std::size_t>(state)] &
+            impl::attribute::dead) != 0U;
+}
+
+[[nodiscard]] auto live_closure(impl::lambda_closures const& closures,
+                                std::vector<std::uint8_t> const& attributes,
+                                int const state) -> std::vector<int>
+{
+    std::vector<int> result{};
+
+    for(int const reached : closures.of(state)) {
+        if(!is_dead(attributes, reached)) {
+            result.push_back(reached);
+        }
+    }
+
+    return result;
+}
+
+// Lambda-closed states reached from `subset` on `ch`, without the dead ones
+[[nodiscard]] auto successors(builder const& build,
+                              impl::lambda_closures const& closures,
+                              std::vector<std::uint8_t> const& attributes,
+                              std::vector<int> const& subset,
+                              char const ch) -> std::vector<int>
+{
+    auto const& autom = build.get_configuration();
+    std::vector<int> result{};
+
+    for(int const state : subset) {
+        auto const it = autom.find(state);
+
+        if(it == autom.end()) {
+            continue;
+        }
+
+        for(auto const& transition : it->second) {
+            if(transition.on == ch) {
+                auto const reached =
+                    live_closure(closures, attributes, transition.to);
+                result.insert(result.end(), reached.begin(), reached.end());
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+[[nodiscard]] auto flags_of(std::vector<std::uint8_t> const& attributes,
+                            std::vector<int> const& subset) -> std::uint8_t
+{
+    unsigned flags{ 0U };
+
+    for(int const state : subset) {
+        flags |= attributes[static_cast<std::size_t>(state)];
+    }
+
+    return static_cast<std::uint8_t>(
+        flags & (impl::attribute::accepting | impl::attribute::accept_all));
+}
+
+// Subset construction giving up as soon as it goes over the budget
+[[nodiscard]] auto determinize(builder const& build,
+                               impl::lambda_closures const& closures,
+                               std::vector<std::uint8_t> const& attributes,
+                               budget const& limits) -> std::optional<builder>
+{
+    trace::scope phase{ trace::phase::subset_construction,
+                        closures.state_count() };
+
+    auto const alphabet = build.get_alphabet();
+    builder result{};
+    std::map<std::vector<int>, int> seen{};
+    std::deque<std::vector<int>> queue{};
+    std::size_t bytes{ 0 };
+    bool over_budget{ false };
+
+    auto add_subset = [&](std::vector<int> subset) -> int {
+        auto const [it, inserted] =
+            seen.try_emplace(subset, static_cast<int>(seen.size()));
+
+        if(inserted) {
+            bytes += cost(alphabet.size() + 1U, subset.size());
+            over_budget = over_budget || seen.size() > limits.max_states ||
+                          bytes > limits.max_bytes;
+
+            if((flags_of(attributes, subset) & impl::attribute::accepting) !=
+               0U) {
+                result.set_accepting_state(it->second);
+            }
+            queue.push_back(std::move(subset));
+        }
+
+        return it->second;
+    };
+
+    result.set_starting_state(add_subset(
+        live_closure(closures, attributes, build.get_starting_state())));
+
+    for(; !queue.empty() && !over_budget; queue.pop_front()) {
+        auto const subset = queue.front();
+        int const from = seen.at(subset);
+
+        for(char const ch : alphabet) {
+            auto next = successors(build, closures, attributes, subset, ch);
+
+            if(!next.empty()) {
+                result.add_transition(from, ch, add_subset(std::move(next)));
+            }
+        }
+    }
+
+    phase.set_states_out(seen.size());
+
+    if(over_budget) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+// Moore's partition refinement of a DFA whose states are all reachable
+[[nodiscard]] auto minimize(builder const& build) -> builder
+{
+    auto const n = impl::state_count(build);
+    trace::scope phase{ trace::phase::equivalence_merging, n };
+
+    auto const alphabet = build.get_alphabet();
+    auto const k = alphabet.size();
+    std::vector<int> next(n * k, dead);
+    std::vector<bool> accepting(n, false);
+
+    for(auto const& [state, transitions] : build.get_configuration()) {
+        for(auto const& transition : transitions) {
+            next[static_cast<std::size_t>(state) * k +
+                 alphabet.find(transition.on)] = transition.to;
+        }
+    }
+    for(int const state : build.get_accepting_states()) {
+        accepting[static_cast<std::size_t>(state)] = true;
+    }
+
+    std::vector<int> block(n, 0);
+    std::size_t block_count{ 0 };
+
+    for(std::size_t state = 0; state < n; ++state) {
+        block[state] = accepting[state] ? 1 : 0;
+    }
+
+    // blocks only ever split, they are stable once their number stays the same
+    for(bool stable = false; !stable;) {
+        std::map<std::vector<int>, int> signatures{};
+        std::vector<int> refined(n, 0);
+
+        for(std::size_t state = 0; state < n; ++state) {
+            std::vector<int> signature{ block[state] };
+
+            for(std::size_t ch = 0; ch < k; ++ch) {
+                int const to = next[state * k + ch];
+                signature.push_back(
+                    to == dead ? dead : block[static_cast<std::size_t>(to)]);
+            }
+
+            refined[state] =
+                signatures
+                    .try_emplace(std::move(signature),
+                                 static_cast<int>(signatures.size()))
+                    .first->second;
+        }
+
+        stable = signatures.size() == block_count;
+        block_count = signatures.size();
+        block.swap(refined);
+    }
+
+    builder result{};
+    std::vector<bool> emitted(block_count, false);
+
+    result.set_starting_state(
+        block[static_cast<std::size_t>(build.get_starting_state())]);
+
+    for(std::size_t state = 0; state < n; ++state) {
+        int const from = block[state];
+
+        if(emitted[static_cast<std::size_t>(from)]) {
+            continue;
+        }
+
+        emitted[static_cast<std::size_t>(from)] = true;
+        if(accepting[state]) {
+            result.set_accepting_state(from);
+        }
+
+        for(std::size_t ch = 0; ch < k; ++ch) {
+            int const to = next[state * k + ch];
+
+            if(to != dead) {
+                result.add_transition(
+                    from, alphabet[ch], block[static_cast<std::size_t>(to)]);
+            }
+        }
+    }
+
+    phase.set_states_out(block_count);
+
+    return result;
+}
+
+} // namespace
+
+hybrid::hybrid(builder const& build, budget const& limits)
+    : m_budget{ limits }
+{
+    impl::lambda_closures closures{ build };
+    // the byte 0 matches nothing here, lambda edges cover no byte
+    auto attributes =
+        impl::compute_attributes(build, impl::lambda_mode::epsilon);
+
+    if(auto const full = determinize(build, closures, attributes, limits)) {
+        m_engine = engine::dfa;
+        m_table = impl::dfa_table{ minimize(*full) };
+        return;
+    }
+
+    m_engine = engine::lazy_dfa;
+    m_caches = std::make_shared<impl::lazy_pool>();
+    m_builder = build;
+    m_closures = std::move(closures);
+    m_attributes = std::move(attributes);
+
+    // one class per character of the alphabet, class 0 for the other bytes
+    m_representatives.push_back('\0');
+    for(char const ch : m_builder.get_alphabet()) {
+        m_classes[static_cast<unsigned char>(ch)] =
+            static_cast<std::uint16_t>(m_representatives.size());
+        m_representatives.push_back(ch);
+    }
+}
+
+auto hybrid::add_subset(impl::lazy_cache& cache, std::vector<int> subset) const
+    -> int
+{
+    auto const found = cache.ids.find(subset);
+
+    if(found != cache.ids.end()) {
+        return found->second;
+    }
+
+    auto const class_count = m_representatives.size();
+    auto const bytes = cost(class_count, subset.size());
+
+    // start over rather than grow past the budget, the states are found again
+    // if they are needed
+    if(!cache.subsets.empty() && cache.bytes + bytes > m_budget.max_bytes) {
+        cache.ids.clear();
+        cache.subsets.clear();
+        cache.next.clear();
+        cache.attributes.clear();
+        cache.bytes = 0U;
+        ++cache.flushes;
+    }
+
+    int const id = static_cast<int>(cache.subsets.size());
+
+    cache.attributes.push_back(flags_of(m_attributes, subset));
+    cache.ids.emplace(subset, id);
+    cache.subsets.push_back(std::move(subset));
+    cache.next.resize(cache.next.size() + class_count,
+                      impl::lazy_cache::unknown);
+    cache.bytes += bytes;
+
+    return id;
+}
+
+auto hybrid::lazy_step(impl::lazy_cache& cache,
+                       int const state,
+                       std::size_t const cls) const -> int
+{
+    int to = dead;
+
+    if(cls != 0U) {
+        auto next = successors(m_builder,
+                               m_closures,
+                               m_attributes,
+                               cache.subsets[static_cast<std::size_t>(state)],
+                               m_representatives[cls]);
+
+        if(!next.empty()) {
+            auto const flushes = cache.flushes;
+            to = this->add_subset(cache, std::move(next));
+
+            // `state` went away with the rest of the cache
+            if(cache.flushes != flushes) {
+                return to;
+            }
+        }
+    }
+
+    cache.next[static_cast<std::size_t>(state) * m_representatives.size() +
+               cls] = to;
+    return to;
+}
+
+auto hybrid::chosen() const noexcept -> engine
+{
+    return m_engine;
+}
+
+auto hybrid::state_count() const noexcept -> std::size_t
+{
+    return m_engine == engine::dfa ? m_table.state_count() : 0U;
+}
+
+auto hybrid::initial() const -> run_state
+{
+    run_state run{};
+
+    if(m_engine == engine::dfa) {
+        run.state = m_table.start();
+        return run;
+    }
+
+    run.cache = impl::lazy_lease{ m_caches->take().release(),
+                                  impl::lazy_return{ m_caches } };
+    run.state = this->add_subset(
+        *run.cache,
+        live_closure(
+            m_closures, m_attributes, m_builder.get_starting_state()));
+    return run;
+}
+
+auto hybrid::step(run_state& run, char const input) const -> bool
+{
+    if(m_engine == engine::dfa) {
+        run.state = m_table.step(run.state, input);
+        return run.state != dead && !m_table.accepts_all(run.state);
+    }
+
+    auto& cache = *run.cache;
+    auto const cls = static_cast<std::size_t>(
+        m_classes[static_cast<unsigned char>(input)]);
+    int to = cache.next[static_cast<std::size_t>(run.state) *
+                            m_representatives.size() +
+                        cls];
+
+    if(to == impl::lazy_cache::unknown) {
+        to = this->lazy_step(cache, run.state, cls);
+    }
+
+    run.state = to;
+    return to != dead && (cache.attributes[static_cast<std::size_t>(to)] &
+                          impl::attribute::accept_all) == 0U;
+}
+
+auto hybrid::is_accepting(run_state const& run) const noexcept -> bool
+{
+    if(run.state == dead) {
+        return false;
+    }
+    if(m_engine == engine::dfa) {
+        return m_table.accepting(run.state);
+    }
+
+    return (run.cache->attributes[static_cast<std::size_t>(run.state)] &
+            impl::attribute::accepting) != 0U;
+}
+
+namespace impl {
+
+auto lazy_pool::take() -> std::unique_ptr<lazy_cache>
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+
+        if(!m_idle.empty()) {
+            auto cache = std::move(m_idle.back());
+            m_idle.pop_back();
+            return cache;
+        }
+    }
+
+    return std::make_unique<lazy_cache>();
+}
+
+auto lazy_pool::give_back(std::unique_ptr<lazy_cache> cache) noexcept -> void
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    // the cache is only dropped if it can't be kept
+    try {
+        m_idle.push_back(std::move(cache));
+    }
+    catch(std::bad_alloc const&) {
+    }
+}
+
+auto lazy_return::operator()(lazy_cache* const cache) const noexcept -> void
+{
+    std::unique_ptr<lazy_cache> owned{ cache };
+
+    if(pool) {
+        pool->give_back(std::move(owned));
+    }
+}
+
+} // namespace impl
+
+auto name(hybrid::engine const chosen) noexcept -> char const*
+{
+    switch(chosen) {
+    case hybrid::engine::dfa:
+        return "dfa";
+    case hybrid::engine::lazy_dfa:
+        return "lazy_dfa";
+    }
+
+    return "unknown";
+}
+
+} // namespace fsm
@@ -0,0 +1,149 @@
+#ifndef HYBRID_HPP
+#define HYBRID_HPP
+#pragma once
+
+#include "closure.hpp"
+#include "dfa_table.hpp"
+#include "fsm_builder.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fsm {
+
+class budget
+{
+public:
+    // states the full DFA may have
+    std::size_t max_states{ std::size_t{ 1 } << 12U };
+    // bytes of transitions and subsets, for the full DFA as well as for the
+    // cache of the lazy DFA
+    std::size_t max_bytes{ std::size_t{ 1 } << 22U };
+};
+
+namespace impl {
+
+// States of the lazy DFA discovered so far, used by one run at a time
+class lazy_cache
+{
+public:
+    static constexpr int unknown = -2;
+
+    // sorted NFA states -> lazy state
+    std::map<std::vector<int>, int> ids{};
+    std::vector<std::vector<int>> subsets{};
+    // row-major like dfa_table, unknown until the transition is taken once
+    std::vector<int> next{};
+    std::vector<std::uint8_t> attributes{};
+    std::size_t bytes{ 0 };
+    // number of times the cache outgrew the budget and was cleared
+    std::size_t flushes{ 0 };
+};
+
+// Caches no run is using, so the next runs start from the states the ones
+// before them discovered. There are as many caches as runs going on at once.
+class lazy_pool
+{
+private:
+    std::mutex m_mutex{};
+    std::vector<std::unique_ptr<lazy_cache>> m_idle{};
+
+public:
+    // An idle cache, or an empty one if every cache is in use
+    [[nodiscard]] auto take() -> std::unique_ptr<lazy_cache>;
+    auto give_back(std::unique_ptr<lazy_cache> cache) noexcept -> void;
+};
+
+// Deleter giving a cache back to its pool once the run holding it is done
+class lazy_return
+{
+public:
+    std::shared_ptr<lazy_pool> pool{};
+
+    auto operator()(lazy_cache* const cache) const noexcept -> void;
+};
+
+using lazy_lease = std::unique_ptr<lazy_cache, lazy_return>;
+
+} // namespace impl
+
+// Matcher for (lambda-)NFAs whose determinization never goes over a budget.
+//
+// The full DFA is built and minimized when it fits, otherwise DFA states are
+// only discovered while matching and the cache holding them is cleared each
+// time it outgrows the budget: matching gets slower instead of running out of
+// memory. The discovered states outlive a run: each run borrows a cache from
+// the matcher and gives it back when it's done, so the copies of a matcher
+// share their caches and runs on different threads still need no locking.
+// Transitions on fsm::lambda are lambda transitions, the byte 0 is never
+// matched.
+class hybrid
+{
+public:
+    enum class engine
+    {
+        dfa,
+        lazy_dfa
+    };
+
+    class run_state
+    {
+    public:
+        int state{ impl::dfa_table::dead };
+        // engine::lazy_dfa only, `state` is an id in it
+        impl::lazy_lease cache{};
+    };
+
+private:
+    engine m_engine{ engine::dfa };
+    budget m_budget{};
+    // engine::dfa
+    impl::dfa_table m_table{};
+
+    // engine::lazy_dfa
+    builder m_builder{};
+    impl::lambda_closures m_closures{};
+    std::vector<std::uint8_t> m_attributes{};
+    // byte -> class, class 0 has no transitions at all
+    std::array<std::uint16_t, 256> m_classes{};
+    // class -> a byte in it
+    std::vector<char> m_representatives{};
+    std::shared_ptr<impl::lazy_pool> m_caches{};
+
+    [[nodiscard]] auto add_subset(impl::lazy_cache& cache,
+                                  std::vector<int> subset) const -> int;
+    [[nodiscard]] auto lazy_step(impl::lazy_cache& cache,
+                                 int const state,
+                                 std::size_t const cls) const -> int;
+
+public:
+    hybrid() = delete;
+    hybrid(hybrid const&) = default;
+    hybrid(hybrid&&) noexcept = default;
+    ~hybrid() noexcept = default;
+
+    explicit hybrid(builder const& build, budget const& limits = budget{});
+
+    auto operator=(hybrid const&) -> hybrid& = default;
+    auto operator=(hybrid&&) noexcept -> hybrid& = default;
+
+    [[nodiscard]] auto chosen() const noexcept -> engine;
+    // states of the minimized DFA, 0 when it went over the budget
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+
+    [[nodiscard]] auto initial() const -> run_state;
+    [[nodiscard]] auto step(run_state& run, char const input) const -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& run) const noexcept
+        -> bool;
+};
+
+[[nodiscard]] auto name(hybrid::engine const chosen) noexcept -> char const*;
+
+} // namespace fsm
+
+#endif // !HYBRID_HPP
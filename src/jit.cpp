@@ -0,0 +1,244 @@
+#include "jit.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && defined(__x86_64__)
+#define LFA_JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+namespace fsm {
+
+namespace {
+
+#ifdef LFA_JIT_X86_64
+
+// Machine code for bool(unsigned char const* it, unsigned char const* end),
+// `it` lives in rdi and `end` in rsi like the System V ABI passes them
+class assembler
+{
+private:
+    class fixup
+    {
+    public:
+        // offset of the rel32 to patch
+        std::size_t at{ 0 };
+        int state{ 0 };
+    };
+
+    std::vector<std::uint8_t> m_code{};
+    std::vector<std::size_t> m_labels{};
+    std::vector<fixup> m_fixups{};
+
+    auto bytes(std::initializer_list<std::uint8_t> const values) -> void
+    {
+        m_code.insert(m_code.end(), values.begin(), values.end());
+    }
+
+    auto imm32(std::uint32_t const value) -> void
+    {
+        for(unsigned shift = 0; shift < 32U; shift += 8U) {
+            m_code.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+
+    auto jump_to(int const state) -> void
+    {
+        m_fixups.push_back(fixup{ m_code.size(), state });
+        imm32(0U);
+    }
+
+    auto return_value(bool const value) -> void
+    {
+        // mov eax, value; ret
+        bytes({ 0xB8 });
+        imm32(value ? 1U : 0U);
+        bytes({ 0xC3 });
+    }
+
+public:
+    explicit assembler(std::size_t const state_count)
+        : m_labels(state_count, 0U)
+    {
+    }
+
+    auto state(impl::dfa_table const& table, int const state) -> void
+    {
+        m_labels[static_cast<std::size_t>(state)] = m_code.size();
+
+        if(table.accepts_all(state)) {
+            return_value(true);
+            return;
+        }
+
+        // cmp rdi, rsi; jne +6; mov eax, accepting; ret
+        bytes({ 0x48, 0x39, 0xF7, 0x75, 0x06 });
+        return_value(table.accepting(state));
+        // movzx eax, byte [rdi]; inc rdi
+        bytes({ 0x0F, 0xB6, 0x07, 0x48, 0xFF, 0xC7 });
+
+        for(auto const& range : table.ranges_of(state)) {
+            unsigned const low = range.low;
+            unsigned const high = range.high;
+
+            if(low == 0U && high == 0xFFU) {
+                // jmp
+                bytes({ 0xE9 });
+            }
+            else if(low == high) {
+                // cmp eax, low; je
+                bytes({ 0x3D });
+                imm32(low);
+                bytes({ 0x0F, 0x84 });
+            }
+            else {
+                // lea ecx, [rax - low]; cmp ecx, high - low; jbe
+                bytes({ 0x8D, 0x88 });
+                imm32(0U - low);
+                bytes({ 0x81, 0xF9 });
+                imm32(high - low);
+                bytes({ 0x0F, 0x86 });
+            }
+            jump_to(range.to);
+        }
+
+        return_value(false);
+    }
+
+    [[nodiscard]] auto finish() -> std::vector<std::uint8_t>
+    {
+        for(auto const& [at, target] : m_fixups) {
+            auto const to = m_labels[static_cast<std::size_t>(target)];
+            auto const rel = static_cast<std::int64_t>(to) -
+                             static_cast<std::int64_t>(at + 4U);
+            auto const value = static_cast<std::uint32_t>(rel);
+
+            for(unsigned i = 0; i < 4U; ++i) {
+                m_code[at + i] = static_cast<std::uint8_t>(value >> (8U * i));
+            }
+        }
+
+        return std::move(m_code);
+    }
+};
+
+#endif
+
+} // namespace
+
+jit::jit(dfa const& automaton)
+    : m_table{ automaton.table() }
+{
+#ifdef LFA_JIT_X86_64
+    assembler code{ m_table.state_count() };
+
+    // the start comes first, execution begins at offset 0
+    for(int const state : m_table.reachable()) {
+        code.state(m_table, state);
+    }
+
+    auto const machine_code = code.finish();
+    void* const page = mmap(nullptr,
+                            machine_code.size(),
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS,
+                            -1,
+                            0);
+
+    if(page == MAP_FAILED) {
+        return;
+    }
+
+    std::memcpy(page, machine_code.data(), machine_code.size());
+
+    // never writable and executable at the same time
+    if(mprotect(page, machine_code.size(), PROT_READ | PROT_EXEC) != 0) {
+        munmap(page, machine_code.size());
+        return;
+    }
+
+    m_code = page;
+    m_code_size = machine_code.size();
+    m_function = reinterpret_cast<function_t>(page);
+#endif
+}
+
+jit::jit(jit&& other) noexcept
+    : m_table{ std::move(other.m_table) }
+    , m_code{ std::exchange(other.m_code, nullptr) }
+    , m_code_size{ std::exchange(other.m_code_size, 0U) }
+    , m_function{ std::exchange(other.m_function, nullptr) }
+{
+}
+
+jit::~jit() noexcept
+{
+    this->release();
+}
+
+auto jit::operator=(jit&& other) noexcept -> jit&
+{
+    if(this != &other) {
+        this->release();
+        m_table = std::move(other.m_table);
+        m_code = std::exchange(other.m_code, nullptr);
+        m_code_size = std::exchange(other.m_code_size, 0U);
+        m_function = std::exchange(other.m_function, nullptr);
+    }
+
+    return *this;
+}
+
+auto jit::release() noexcept -> void
+{
+#ifdef LFA_JIT_X86_64
+    if(m_code != nullptr) {
+        munmap(m_code, m_code_size);
+    }
+#endif
+
+    m_code = nullptr;
+    m_code_size = 0U;
+    m_function = nullptr;
+}
+
+auto jit::accepts(std::string_view const input) const noexcept -> bool
+{
+    if(m_function != nullptr) {
+        auto const* const begin =
+            reinterpret_cast<unsigned char const*>(input.data());
+        return m_function(begin, begin + input.size());
+    }
+
+    int state = m_table.start();
+
+    for(char const tok : input) {
+        if(m_table.accepts_all(state)) {
+            return true;
+        }
+
+        state = m_table.step(state, tok);
+
+        if(state == impl::dfa_table::dead) {
+            return false;
+        }
+    }
+
+    return m_table.accepting(state);
+}
+
+auto jit::native() const noexcept -> bool
+{
+    return m_function != nullptr;
+}
+
+auto jit::code_size() const noexcept -> std::size_t
+{
+    return m_code_size;
+}
+
+} // namespace fsm
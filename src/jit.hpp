@@ -0,0 +1,51 @@
+#ifndef JIT_HPP
+#define JIT_HPP
+#pragma once
+
+#include "dfa.hpp"
+#include "dfa_table.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+namespace fsm {
+
+// DFA compiled to native code at runtime.
+//
+// On Linux/x86-64 every state becomes a few compare-and-jump instructions in a
+// page that is writable while it's being filled, then only executable. Other
+// platforms, or a failed mapping, fall back to the table-driven loop with the
+// same results.
+class jit
+{
+private:
+    using function_t = bool (*)(unsigned char const*, unsigned char const*);
+
+    impl::dfa_table m_table{};
+    void* m_code{ nullptr };
+    std::size_t m_code_size{ 0 };
+    function_t m_function{ nullptr };
+
+    auto release() noexcept -> void;
+
+public:
+    jit() = delete;
+    jit(jit const&) = delete;
+    jit(jit&& other) noexcept;
+    ~jit() noexcept;
+
+    explicit jit(dfa const& automaton);
+
+    auto operator=(jit const&) -> jit& = delete;
+    auto operator=(jit&& other) noexcept -> jit&;
+
+    [[nodiscard]] auto accepts(std::string_view const input) const noexcept
+        -> bool;
+    // false when matching falls back to the table
+    [[nodiscard]] auto native() const noexcept -> bool;
+    [[nodiscard]] auto code_size() const noexcept -> std::size_t;
+};
+
+} // namespace fsm
+
+#endif // !JIT_HPP
@@ -0,0 +1,178 @@
+#include "layout.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace fsm::impl {
+
+namespace {
+
+class profile
+{
+public:
+    std::vector<std::size_t> visits{};
+    // from * state_count + to -> number of steps
+    std::unordered_map<std::size_t, std::size_t> edges{};
+};
+
+[[nodiscard]] auto run(dfa_table const& table, std::string_view const sample)
+    -> profile
+{
+    auto const state_count = table.state_count();
+    profile result{};
+    int state = table.start();
+
+    result.visits.assign(state_count, 0U);
+    ++result.visits[static_cast<std::size_t>(state)];
+
+    for(char const ch : sample) {
+        int const to = table.step(state, ch);
+
+        if(to == dfa_table::dead || table.accepts_all(state)) {
+            state = table.start();
+        }
+        else {
+            auto const key = static_cast<std::size_t>(state) * state_count +
+                             static_cast<std::size_t>(to);
+            ++result.edges[key];
+            state = to;
+        }
+
+        ++result.visits[static_cast<std::size_t>(state)];
+    }
+
+    return result;
+}
+
+// Every state, the reachable ones in breadth first order
+[[nodiscard]] auto bfs_order(dfa_table const& table) -> std::vector<int>
+{
+    auto result = table.reachable();
+    std::vector<bool> placed(table.state_count(), false);
+
+    for(int const state : result) {
+        placed[static_cast<std::size_t>(state)] = true;
+    }
+    for(std::size_t state = 0; state < placed.size(); ++state) {
+        if(!placed[state]) {
+            result.push_back(static_cast<int>(state));
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]] auto frequency_order(dfa_table const& table,
+                                   std::string_view const sample)
+    -> std::vector<int>
+{
+    auto const visits = run(table, sample).visits;
+    auto result = bfs_order(table);
+
+    // ties keep the breadth first order
+    std::stable_sort(result.begin(), result.end(), [&visits](int a, int b) {
+        return visits[static_cast<std::size_t>(a)] >
+               visits[static_cast<std::size_t>(b)];
+    });
+
+    return result;
+}
+
+[[nodiscard]] auto co_access_order(dfa_table const& table,
+                                   std::string_view const sample)
+    -> std::vector<int>
+{
+    constexpr int none = -1;
+    auto const state_count = table.state_count();
+    auto const profiled = run(table, sample);
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges{};
+    edges.reserve(profiled.edges.size());
+    for(auto const& [key, count] : profiled.edges) {
+        edges.emplace_back(count, key);
+    }
+    std::sort(edges.begin(), edges.end(), [](auto const& a, auto const& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    // chains of states, glued tail to head along the hottest edges first
+    std::vector<int> next(state_count, none);
+    std::vector<int> previous(state_count, none);
+    std::vector<std::size_t> chain(state_count, 0U);
+
+    for(std::size_t state = 0; state < state_count; ++state) {
+        chain[state] = state;
+    }
+
+    auto chain_of = [&chain](std::size_t state) -> std::size_t {
+        while(chain[state] != state) {
+            chain[state] = chain[chain[state]];
+            state = chain[state];
+        }
+        return state;
+    };
+
+    for(auto const& [count, key] : edges) {
+        auto const from = key / state_count;
+        auto const to = key % state_count;
+
+        if(next[from] != none || previous[to] != none ||
+           chain_of(from) == chain_of(to)) {
+            continue;
+        }
+
+        next[from] = static_cast<int>(to);
+        previous[to] = static_cast<int>(from);
+        chain[chain_of(to)] = chain_of(from);
+    }
+
+    // chains go hottest first, a chain is as hot as all its states together
+    std::vector<std::size_t> heat(state_count, 0U);
+    for(std::size_t state = 0; state < state_count; ++state) {
+        heat[chain_of(state)] += profiled.visits[state];
+    }
+
+    std::vector<int> heads{};
+    for(int const state : bfs_order(table)) {
+        if(previous[static_cast<std::size_t>(state)] == none) {
+            heads.push_back(state);
+        }
+    }
+    std::stable_sort(heads.begin(), heads.end(), [&](int a, int b) {
+        return heat[chain_of(static_cast<std::size_t>(a))] >
+               heat[chain_of(static_cast<std::size_t>(b))];
+    });
+
+    std::vector<int> result{};
+    result.reserve(state_count);
+
+    for(int const head : heads) {
+        for(int state = head; state != none;
+            state = next[static_cast<std::size_t>(state)]) {
+            result.push_back(state);
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+auto state_order(dfa_table const& table,
+                 layout const strategy,
+                 std::string_view const sample) -> std::vector<int>
+{
+    switch(strategy) {
+    case layout::bfs:
+        return bfs_order(table);
+    case layout::frequency:
+        return frequency_order(table, sample);
+    case layout::co_access:
+        return co_access_order(table, sample);
+    }
+
+    return bfs_order(table);
+}
+
+} // namespace fsm::impl
@@ -0,0 +1,38 @@
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+#pragma once
+
+#include "dfa_table.hpp"
+
+#include <string_view>
+#include <vector>
+
+namespace fsm {
+
+// Order of the rows of a transition table
+enum class layout
+{
+    // breadth first from the start, states close to it come first
+    bfs,
+    // most visited states first while matching a sample
+    frequency,
+    // states often stepped between while matching a sample are put next to
+    // each other (Pettis-Hansen chaining of the hottest transitions)
+    co_access
+};
+
+namespace impl {
+
+// Order in which to renumber the states of `table`. `sample` is only used by
+// layout::frequency and layout::co_access, matching restarts from the start
+// every time it gets stuck on it.
+[[nodiscard]] auto state_order(dfa_table const& table,
+                               layout const strategy,
+                               std::string_view const sample)
+    -> std::vector<int>;
+
+} // namespace impl
+
+} // namespace fsm
+
+#endif // !LAYOUT_HPP
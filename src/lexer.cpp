@@ -0,0 +1,268 @@
+#include "lexer.hpp"
+#include "closure.hpp"
+#include "lnfa.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <map>
+
+namespace fsm {
+
+namespace {
+
+class tagged_dfa
+{
+public:
+    builder build{};
+    // builder state -> rule accepting there
+    std::vector<int> rules{};
+};
+
+// Subset construction over the union of all the rules
+[[nodiscard]] auto compile(std::vector<builder> const& rules) -> tagged_dfa
+{
+    builder combined{};
+    std::vector<int> accepting_rule{};
+    int offset{ 1 };
+
+    combined.set_starting_state(0);
+
+    for(auto r = 0U; r < rules.size(); ++r) {
+        auto const& rule = rules[r];
+        auto const count = static_cast<int>(impl::state_count(rule));
+
+        combined.add_transition(0, lambda, offset + rule.get_starting_state());
+
+        for(auto const& [state, transitions] : rule.get_configuration()) {
+            for(auto const& transition : transitions) {
+                combined.add_transition(
+                    offset + state, transition.on, offset + transition.to);
+            }
+        }
+
+        accepting_rule.resize(static_cast<std::size_t>(offset + count),
+                              lexer::no_rule);
+
+        for(int const state : rule.get_accepting_states()) {
+            auto const index = static_cast<std::size_t>(offset + state);
+
+            if(accepting_rule[index] == lexer::no_rule) {
+                accepting_rule[index] = static_cast<int>(r);
+            }
+        }
+
+        offset += count;
+    }
+
+    // state 0 and the rules' states without outgoing transitions
+    accepting_rule.resize(
+        std::max(accepting_rule.size(), impl::state_count(combined)),
+        lexer::no_rule);
+
+    impl::lambda_closures const closures{ combined };
+    auto const& autom = combined.get_configuration();
+    auto const alphabet = combined.get_alphabet();
+
+    tagged_dfa result{};
+    std::map<std::vector<int>, int> seen{};
+    std::deque<std::vector<int>> queue{};
+
+    auto add_subset = [&](std::vector<int> subset) -> int {
+        auto const [it, inserted] =
+            seen.try_emplace(subset, static_cast<int>(seen.size()));
+
+        if(inserted) {
+            int rule = lexer::no_rule;
+
+            // rules are ordered by priority, the smallest index wins
+            for(int const state : subset) {
+                int const owner =
+                    accepting_rule[static_cast<std::size_t>(state)];
+
+                if(owner != lexer::no_rule &&
+                   (rule == lexer::no_rule || owner < rule)) {
+                    rule = owner;
+                }
+            }
+
+            result.rules.push_back(rule);
+            if(rule != lexer::no_rule) {
+                result.build.set_accepting_state(it->second);
+            }
+            queue.push_back(std::move(subset));
+        }
+
+        return it->second;
+    };
+
+    auto const start = closures.of(0);
+    result.build.set_starting_state(
+        add_subset(std::vector<int>(start.begin(), start.end())));
+
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const subset = queue.front();
+        int const from = seen.at(subset);
+
+        for(char const ch : alphabet) {
+            std::vector<int> next{};
+
+            for(int const state : subset) {
+                auto const it = autom.find(state);
+
+                if(it == autom.end()) {
+                    continue;
+                }
+
+                for(auto const& transition : it->second) {
+                    if(transition.on == ch) {
+                        auto const closure = closures.of(transition.to);
+                        next.insert(next.end(), closure.begin(), closure.end());
+                    }
+                }
+            }
+
+            if(next.empty()) {
+                continue;
+            }
+
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+
+            result.build.add_transition(from, ch, add_subset(std::move(next)));
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+lexer::lexer(std::vector<builder> const& rules)
+{
+    auto const compiled = compile(rules);
+
+    m_table = impl::dfa_table{ compiled.build };
+    m_rules.resize(m_table.state_count());
+
+    for(std::size_t state = 0; state < m_rules.size(); ++state) {
+        auto const id = m_table.id_of(static_cast<int>(state));
+        m_rules[state] = compiled.rules[static_cast<std::size_t>(id)];
+    }
+}
+
+auto lexer::next_token(std::string_view const input,
+                       std::size_t& position) const -> token
+{
+    return this->scan(input, position, nullptr);
+}
+
+auto lexer::next_token(std::string_view const input,
+                       std::size_t& position,
+                       memo& scans) const -> token
+{
+    return this->scan(input, position, &scans);
+}
+
+auto lexer::remember_failures(std::string_view const input,
+                              int state,
+                              std::size_t const from,
+                              std::size_t const stop,
+                              memo& scans) const -> void
+{
+    // the states are found again by walking from the last accepting one
+    for(auto i = from; i < stop; ++i) {
+        state = m_table.step(state, input[i]);
+        scans.failed.emplace(i + 1U, state);
+    }
+
+    scans.horizon = std::max(scans.horizon, stop);
+}
+
+auto lexer::scan(std::string_view const input,
+                 std::size_t& position,
+                 memo* const scans) const -> token
+{
+    int state = m_table.start();
+    int last_rule = no_rule;
+    int last_state = state;
+    std::size_t last_end = position;
+    // furthest position reached without accepting after last_end
+    std::size_t stop = position;
+
+    if(scans != nullptr && position >= scans->horizon &&
+       !scans->failed.empty()) {
+        scans->failed.clear();
+    }
+
+    // the memo doesn't change during the scan
+    bool const memoized = scans != nullptr && !scans->failed.empty();
+
+    for(std::size_t i = position; i < input.size(); ++i) {
+        state = m_table.step(state, input[i]);
+
+        if(state == impl::dfa_table::dead) {
+            break;
+        }
+
+        int const rule = m_rules[static_cast<std::size_t>(state)];
+
+        if(rule != no_rule) {
+            last_rule = rule;
+            last_state = state;
+            last_end = i + 1U;
+            continue;
+        }
+
+        // an earlier scan went on from here and never accepted again
+        if(memoized && scans->failed.count({ i + 1U, state }) != 0U) {
+            break;
+        }
+        stop = i + 1U;
+    }
+
+    if(scans != nullptr && stop > last_end) {
+        this->remember_failures(input, last_state, last_end, stop, *scans);
+    }
+
+    if(last_rule == no_rule) {
+        // skip a single character nothing matched
+        token result{ input.substr(position, 1U), no_rule };
+        position += result.text.size();
+        return result;
+    }
+
+    token result{ input.substr(position, last_end - position), last_rule };
+    position = last_end;
+    return result;
+}
+
+auto lexer::tokenize(std::string_view const input) const -> std::vector<token>
+{
+    std::vector<token> result{};
+    std::size_t position{ 0 };
+    memo scans{};
+
+    while(position < input.size()) {
+        result.push_back(this->next_token(input, position, scans));
+    }
+
+    return result;
+}
+
+auto lexer::memo::pair_hash::operator()(pair const& key) const noexcept
+    -> std::size_t
+{
+    // positions and states are small and dense, spread them over the bits
+    auto const mixed = key.first * 0x9E3779B97F4A7C15ULL +
+                       static_cast<unsigned>(key.second);
+
+    return std::hash<std::size_t>{}(mixed ^ (mixed >> 29U));
+}
+
+auto lexer::state_count() const noexcept -> std::size_t
+{
+    return m_table.state_count();
+}
+
+} // namespace fsm
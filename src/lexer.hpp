@@ -0,0 +1,103 @@
+#ifndef LEXER_HPP
+#define LEXER_HPP
+#pragma once
+
+#include "dfa_table.hpp"
+#include "fsm_builder.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace fsm {
+
+// Tokenizer built from an ordered list of rules.
+//
+// Every rule is a (lambda-)NFA, they are all compiled into a single DFA whose
+// accepting states remember the first rule accepting there. Tokens are found
+// by maximal munch, earlier rules win ties. Scans that went past the end of
+// their token without accepting again are remembered (Reps' memoization), so
+// tokenizing stays linear in the input even when every token is found by
+// reading far ahead of it.
+class lexer
+{
+public:
+    static constexpr int no_rule = -1;
+
+    class token
+    {
+    public:
+        // slice of the input
+        std::string_view text{};
+        // index of the rule, no_rule for a character nothing matched
+        int rule{ no_rule };
+    };
+
+    // (state, position) pairs of one input from which no accepting state can
+    // be reached anymore, shared by the scans of its tokens
+    class memo
+    {
+    public:
+        // (position, state)
+        using pair = std::pair<std::size_t, int>;
+
+        class pair_hash
+        {
+        public:
+            [[nodiscard]] auto operator()(pair const& key) const noexcept
+                -> std::size_t;
+        };
+
+        std::unordered_set<pair, pair_hash> failed{};
+        // furthest position of a failed pair, the ones before the start of a
+        // scan can't be reached anymore
+        std::size_t horizon{ 0 };
+    };
+
+private:
+    impl::dfa_table m_table{};
+    // dense state of m_table -> rule accepting there
+    std::vector<int> m_rules{};
+
+    // Every pair from (state, from) to stop failed, no scan reaches them again
+    auto remember_failures(std::string_view const input,
+                           int state,
+                           std::size_t const from,
+                           std::size_t const stop,
+                           memo& scans) const -> void;
+    [[nodiscard]] auto scan(std::string_view const input,
+                            std::size_t& position,
+                            memo* const scans) const -> token;
+
+public:
+    lexer() = delete;
+    lexer(lexer const&) = default;
+    lexer(lexer&&) noexcept = default;
+    ~lexer() noexcept = default;
+
+    explicit lexer(std::vector<builder> const& rules);
+
+    auto operator=(lexer const&) -> lexer& = default;
+    auto operator=(lexer&&) noexcept -> lexer& = default;
+
+    // Token starting at `position`, which is moved past it. Input nothing
+    // matches comes back one character at a time with no_rule. Without a
+    // memo, a token can take reading up to the end of the input.
+    [[nodiscard]] auto next_token(std::string_view const input,
+                                  std::size_t& position) const -> token;
+    // Same, stopping early where an earlier scan of `input` with the same
+    // memo already failed
+    [[nodiscard]] auto next_token(std::string_view const input,
+                                  std::size_t& position,
+                                  memo& scans) const -> token;
+    [[nodiscard]] auto tokenize(std::string_view const input) const
+        -> std::vector<token>;
+
+    [[nodiscard]] auto state_count() const noexcept -> std::size_t;
+};
+
+} // namespace fsm
+
+#endif // !LEXER_HPP
@@ -1,65 +1,99 @@
 #include "lnfa.hpp"
 #include "printer.hpp"
+#include "profile.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace fsm {
 
-lnfa::lnfa(builder const& build)
-    : m_builder{ build }
-{
-    m_current_states.push_back(m_builder.get_starting_state());
-}
+namespace {
 
-lnfa::lnfa(builder&& build) noexcept
-    : m_builder{ std::move(build) }
+// Lambda closures of `build`, timed as the lambda_closure phase
+[[nodiscard]] auto traced_closures(builder const& build)
+    -> impl::lambda_closures
 {
-    m_current_states.push_back(m_builder.get_starting_state());
+    trace::scope phase{ trace::phase::lambda_closure,
+                        impl::state_count(build) };
+    impl::lambda_closures result{ build };
+
+    phase.set_states_out(result.component_count());
+    return result;
 }
 
-auto lnfa::check_lambda(std::set<int>& to_check, int const state) -> void
+} // namespace
+
+lnfa::compiled::compiled(builder&& source)
+    : build{ std::move(source) }
+    , attributes{ impl::compute_attributes(build) }
+    , closures{ traced_closures(build) }
+    , grouped{ impl::grouped_by_byte(build) }
 {
-    std::vector<int> with_lambda({ state });
-    std::size_t index{ 0 };
+    // the closures cover every state, the starting one included
+    auto const state_count = closures.state_count();
+    auto const& autom = build.get_configuration();
 
-    auto const& autom = m_builder.get_configuration();
+    rows.reserve(state_count + 1U);
 
-    do {
-        for(auto const& transition : autom.at(with_lambda[index++])) {
-            if(transition.on == lambda) {
-                with_lambda.push_back(transition.to);
-            }
-        }
-    } while(index < with_lambda.size());
+    for(std::size_t state = 0; state < state_count; ++state) {
+        rows.push_back(transitions.size());
 
-    for(int const s : with_lambda) {
-        to_check.insert(s);
+        auto const it = autom.find(static_cast<int>(state));
+        if(it != autom.end()) {
+            transitions.insert(
+                transitions.end(), it->second.begin(), it->second.end());
+        }
     }
+
+    rows.push_back(transitions.size());
 }
 
-auto lnfa::lambda_suffix(int const from) -> std::set<int>
+auto lnfa::empty_program() -> std::shared_ptr<compiled const> const&
 {
-    std::set<int> result{};
+    static auto const program = std::make_shared<compiled const>(builder{});
 
-    this->check_lambda(result, from);
+    return program;
+}
 
-    return result;
+lnfa::lnfa(builder const& build)
+    : m_compiled{ std::make_shared<compiled const>(builder{ build }) }
+{
+    this->reset();
+}
+
+lnfa::lnfa(builder&& build)
+    : m_compiled{ std::make_shared<compiled const>(std::move(build)) }
+{
+    this->reset();
+}
+
+auto lnfa::lambda_suffix(int const from) const -> std::set<int>
+{
+    auto const closure = m_compiled->closures.of(from);
+
+    return std::set<int>(closure.begin(), closure.end());
 }
 
 auto lnfa::can_go_to(std::set<int> const& input, char const on) const
     -> std::set<int>
 {
     std::set<int> result{};
-    auto const& autom = m_builder.get_configuration();
+    auto const& autom = m_compiled->build.get_configuration();
 
     for(int const state : input) {
-        auto const& transitions = autom.at(state);
+        auto const it = autom.find(state);
+
+        if(it == autom.end()) {
+            continue;
+        }
 
-        for(auto const& transition : transitions) {
+        for(auto const& transition : it->second) {
             if(transition.on == on) {
                 result.insert(transition.to);
             }
@@ -71,40 +105,8 @@ auto lnfa::can_go_to(std::set<int> const& input, char const on) const
 
 auto lnfa::next(char const input) -> void
 {
-    std::set<int> to_check{};
-    auto const& autom = m_builder.get_configuration();
-    int const starting_state = m_builder.get_starting_state();
-
-    // case when there is a lambda transition from the starting state
-    bool first_time = m_current_states.size() == 1U &&
-                      m_current_states.back() == starting_state;
-
-    if(first_time) {
-        this->check_lambda(to_check, starting_state);
-
-        for(auto const& state : to_check) {
-            m_current_states.push_back(state);
-        }
-
-        to_check.clear();
-    }
-
-    for(auto const& current_state : m_current_states) {
-        for(auto const& transition : autom.at(current_state)) {
-            if(transition.on == input) {
-                to_check.insert(transition.to);
-                this->check_lambda(to_check, transition.to);
-            }
-        }
-    }
-
-    if(to_check.empty()) {
-        m_aborted = true;
-        return;
-    }
-
-    m_current_states.clear();
-    m_current_states.assign(to_check.begin(), to_check.end());
+    m_aborted = !this->step(m_current_states, input) &&
+                !this->is_accepting(m_current_states);
 }
 
 auto lnfa::aborted() const noexcept -> bool
@@ -114,23 +116,14 @@ auto lnfa::aborted() const noexcept -> bool
 
 auto lnfa::accepted() const noexcept -> bool
 {
-    auto const& accepting_states = m_builder.get_accepting_states();
-
-    for(auto const& state : m_current_states) {
-        auto it =
-            std::find(accepting_states.begin(), accepting_states.end(), state);
-        if(it != accepting_states.end()) {
-            return true;
-        }
-    }
-
-    return false;
+    return this->is_accepting(m_current_states);
 }
 
 auto lnfa::accepts_lambda() noexcept -> bool
 {
-    auto const& states = this->lambda_suffix(m_builder.get_starting_state());
-    auto const& final_states = m_builder.get_accepting_states();
+    auto const& states =
+        this->lambda_suffix(m_compiled->build.get_starting_state());
+    auto const& final_states = m_compiled->build.get_accepting_states();
 
     for(int const state : states) {
         auto const it =
@@ -146,17 +139,16 @@ auto lnfa::accepts_lambda() noexcept -> bool
 
 auto lnfa::reset() -> void
 {
-    m_current_states.clear();
-    m_current_states.push_back(m_builder.get_starting_state());
+    m_current_states = this->initial();
     m_aborted = false;
 }
 
 auto lnfa::print_transitions() -> void
 {
-    auto const& autom = m_builder.get_configuration();
+    auto const& autom = m_compiled->build.get_configuration();
 
     std::cout << "Final states: [ ";
-    for(int const final_state : m_builder.get_accepting_states()) {
+    for(int const final_state : m_compiled->build.get_accepting_states()) {
         std::cout << final_state << ' ';
     }
     std::cout << "]\n";
@@ -171,9 +163,9 @@ auto lnfa::print_transitions() -> void
 auto lnfa::print_enclosing(
     std::map<char, std::vector<std::set<int>>> const& enclosing) -> void
 {
-    // auto const& autom = m_builder.get_configuration();
+    // auto const& autom = m_compiled->build.get_configuration();
 
-    for(char const ch : m_builder.get_alphabet()) {
+    for(char const ch : m_compiled->build.get_alphabet()) {
         std::cout << ch << ":\n";
         auto size = enclosing.at(ch).size();
 
@@ -185,107 +177,76 @@ auto lnfa::print_enclosing(
     }
 }
 
-auto lnfa::get_identical_states(
-    std::map<char, std::vector<std::set<int>>> const& enclosing) const
-    -> std::set<int>
-{
-    auto is_final = [this](unsigned const state) -> bool {
-        auto const it = std::find(m_all_final_states.begin(),
-                                  m_all_final_states.end(),
-                                  static_cast<int>(state));
-        return it != m_all_final_states.end();
-    };
+namespace {
 
-    std::set<int> result{};
-    // path[i] will be where does state i point to on each char of the alphabet
-    // so path[i][j] is where does state i point to on character j
-    // two paths are identical if path[i] == path[j]
-    //  and
-    // is_final(i) == is_final(j)
-    std::vector<std::vector<std::set<int>>> path{};
-    auto const& autom = m_builder.get_configuration();
-
-    for(auto i = 0U; i < autom.size(); ++i) {
-        path.emplace_back();
-
-        for(char const ch : m_builder.get_alphabet()) {
-            path.back().emplace_back(enclosing.at(ch)[i]);
-        }
-    }
-
-    for(auto i = 0U; i < autom.size() - 1; ++i) {
-        bool found{ false };
-
-        for(auto j = i + 1; j < autom.size(); ++j) {
-            if(is_final(i) == is_final(j) && path[i] == path[j]) {
-                result.insert(static_cast<int>(i));
-                result.insert(static_cast<int>(j));
-                found = true;
-            }
+// Hashes the (finality, successor sets) signature of a state
+class signature_hash
+{
+public:
+    [[nodiscard]] auto operator()(std::vector<int> const& signature) const
+        noexcept -> std::size_t
+    {
+        std::size_t seed = signature.size();
+
+        for(int const value : signature) {
+            seed ^= std::hash<int>{}(value) + 0x9e3779b97f4a7c15ULL +
+                    (seed << 6U) + (seed >> 2U);
         }
 
-        if(found) {
-            return result;
-        }
+        return seed;
     }
+};
 
-    return result;
-}
+} // namespace
 
-auto lnfa::rename_redundant_states(std::set<int>& input,
-                                   std::set<int> const& redundant) -> void
+auto lnfa::get_identical_states(
+    std::map<char, std::vector<std::set<int>>> const& enclosing) const
+    -> std::vector<int>
 {
-    if(redundant.empty()) {
-        return;
-    }
-
-    std::set<int> new_set{};
-
-    for(auto const it : input) {
-        if(redundant.count(it) > 0U) {
-            new_set.insert(*redundant.begin());
-        }
-        else {
-            new_set.insert(it);
+    // Two states are identical if they are both final (or both not final) and
+    // they go to the same states on every character of the alphabet.
+    // Every state is mapped to the class of the first state with the same
+    // signature, classes being numbered in order of appearance.
+    std::unordered_map<std::vector<int>, int, signature_hash> classes{};
+    std::vector<int> result{};
+    std::vector<int> signature{};
+    auto const state_count = m_compiled->closures.state_count();
+
+    result.reserve(state_count);
+    classes.reserve(state_count);
+
+    for(auto i = 0U; i < state_count; ++i) {
+        signature.clear();
+        signature.push_back(
+            static_cast<int>(m_all_final_states.count(static_cast<int>(i))));
+
+        for(char const ch : m_compiled->build.get_alphabet()) {
+            auto const& targets = enclosing.at(ch)[i];
+
+            signature.push_back(static_cast<int>(targets.size()));
+            signature.insert(signature.end(), targets.begin(), targets.end());
         }
-    }
-
-    input = new_set;
-}
-
-[[nodiscard]] static auto get_new_index(int const state,
-                                        std::set<int> const& redundant) -> int
-{
-    if(redundant.empty()) {
-        return state;
-    }
 
-    int index{ 0 };
-    auto it = redundant.begin();
-    ++it;
+        auto const next_class = static_cast<int>(classes.size());
+        auto const [it, inserted] = classes.try_emplace(signature, next_class);
+        static_cast<void>(inserted);
 
-    for(; it != redundant.end(); ++it) {
-        if(*it == state) {
-            return *redundant.begin();
-        }
-        if(*it < state) {
-            ++index;
-        }
+        result.push_back(it->second);
     }
 
-    return state - index;
+    return result;
 }
 
 auto lnfa::build_nfa(
     fsm::builder& build,
     std::map<char, std::vector<std::set<int>>> const& enclosing,
-    std::set<int> const& redundant) -> void
+    std::vector<int> const& classes) -> void
 {
-    auto new_idx = [&redundant](int const state) -> int {
-        return get_new_index(state, redundant);
+    auto new_idx = [&classes](int const state) -> int {
+        return classes[static_cast<std::size_t>(state)];
     };
 
-    build.set_starting_state(new_idx(m_builder.get_starting_state()));
+    build.set_starting_state(new_idx(m_compiled->build.get_starting_state()));
 
     std::set<int> unique_final_states{};
     for(int const state : m_all_final_states) {
@@ -295,10 +256,27 @@ auto lnfa::build_nfa(
         build.set_accepting_state(state);
     }
 
-    for(auto const& [ch, states] : enclosing) {
-        for(auto i = 0U; i < states.size(); ++i) {
+    // only the first state of every class keeps its transitions
+    std::vector<bool> emitted(classes.size(), false);
+
+    for(auto i = 0U; i < classes.size(); ++i) {
+        auto const cls = static_cast<std::size_t>(classes[i]);
+
+        if(emitted[cls]) {
+            continue;
+        }
+        emitted[cls] = true;
+
+        std::set<int> targets{};
+
+        for(auto const& [ch, states] : enclosing) {
+            targets.clear();
+
             for(int const state : states[i]) {
-                build.add_transition(static_cast<int>(i), ch, new_idx(state));
+                targets.insert(new_idx(state));
+            }
+            for(int const state : targets) {
+                build.add_transition(classes[i], ch, state);
             }
         }
     }
@@ -307,18 +285,16 @@ auto lnfa::build_nfa(
 auto lnfa::to_nfa() -> builder
 {
     builder result{};
-    std::vector<std::set<int>> path{};
     std::map<char, std::vector<std::set<int>>> enclosing{};
-    auto const& autom = m_builder.get_configuration();
-    auto const& final_states = m_builder.get_accepting_states();
+    auto const& final_states = m_compiled->build.get_accepting_states();
+    auto const state_count = m_compiled->closures.state_count();
 
-    path.resize(autom.size());
     m_all_final_states.insert(final_states.begin(), final_states.end());
 
-    auto is_final = [this](std::set<int> const& set) -> bool {
-        auto const& finals = m_builder.get_accepting_states();
+    auto is_final = [this](impl::closure_range const closure) -> bool {
+        auto const& finals = m_compiled->build.get_accepting_states();
 
-        for(int const state : set) {
+        for(int const state : closure) {
             auto const it = std::find(finals.begin(), finals.end(), state);
 
             if(it != finals.end()) {
@@ -329,24 +305,32 @@ auto lnfa::to_nfa() -> builder
         return false;
     };
 
-    for(auto i = 0U; i < autom.size(); ++i) {
-        path[i] = this->lambda_suffix(static_cast<int>(i));
+    {
+        trace::scope phase{ trace::phase::closed_transitions, state_count };
 
-        if(is_final(path[i])) {
-            m_all_final_states.insert(static_cast<int>(i));
-        }
-
-        for(char const ch : m_builder.get_alphabet()) {
-            auto const& states = this->can_go_to(path[i], ch);
-            std::set<int> final_path{};
+        for(auto i = 0U; i < state_count; ++i) {
+            auto const closure = m_compiled->closures.of(static_cast<int>(i));
+            std::set<int> const path(closure.begin(), closure.end());
 
-            for(int const state : states) {
-                auto const& tmp = this->lambda_suffix(state);
-                final_path.insert(tmp.begin(), tmp.end());
+            if(is_final(closure)) {
+                m_all_final_states.insert(static_cast<int>(i));
             }
 
-            enclosing[ch].push_back(std::move(final_path));
+            for(char const ch : m_compiled->build.get_alphabet()) {
+                auto const& states = this->can_go_to(path, ch);
+                std::set<int> final_path{};
+
+                for(int const state : states) {
+                    auto const target_closure = m_compiled->closures.of(state);
+                    final_path.insert(target_closure.begin(),
+                                      target_closure.end());
+                }
+
+                enclosing[ch].push_back(std::move(final_path));
+            }
         }
+
+        phase.set_states_out(state_count);
     }
 
     /*
@@ -354,47 +338,93 @@ auto lnfa::to_nfa() -> builder
     this->print_enclosing(enclosing);
     */
 
-    auto const& identical_states = this->get_identical_states(enclosing);
+    std::vector<int> classes{};
 
-    /*
-    std::cout << "Identical states: " << std::endl;
-    print(identical_states);
-    std::cout << std::endl << std::endl;
+    {
+        trace::scope phase{ trace::phase::identical_states, state_count };
 
-    std::cout << "Final states: \n";
-    for(auto const s : m_all_final_states) {
-        std::cout << s << ' ';
+        classes = this->get_identical_states(enclosing);
+
+        auto const class_count =
+            classes.empty()
+                ? 0U
+                : static_cast<std::size_t>(
+                      *std::max_element(classes.begin(), classes.end())) +
+                      1U;
+        phase.set_states_out(class_count);
     }
-    std::cout << std::endl;
-    */
 
-    for(auto i = identical_states.size() - 1; i > 0U; --i) {
-        auto it = identical_states.begin();
-        std::advance(it, i);
-        int const state = *it;
+    this->build_nfa(result, enclosing, classes);
 
-        for(char const ch : m_builder.get_alphabet()) {
-            auto iter = enclosing.at(ch).begin();
-            std::advance(iter, state);
-            enclosing.at(ch).erase(iter);
-        }
+    return result;
+}
+
+auto lnfa::is_dead(int const state) const noexcept -> bool
+{
+    return (m_compiled->attributes[static_cast<std::size_t>(state)] &
+            impl::attribute::dead) != 0U;
+}
+
+auto lnfa::initial() const -> run_state
+{
+    int const start = m_compiled->build.get_starting_state();
+    auto const capacity = m_compiled->rows.size() - 1U;
+    run_state states{ impl::sparse_set{ capacity },
+                      impl::sparse_set{ capacity } };
+
+    for(int const state : m_compiled->closures.of(start)) {
+        states.current.insert(state);
     }
 
-    for(char const ch : m_builder.get_alphabet()) {
-        for(auto& set : enclosing.at(ch)) {
-            lnfa::rename_redundant_states(set, identical_states);
+    return states;
+}
+
+auto lnfa::step(run_state& states, char const input) const -> bool
+{
+    auto const& program = *m_compiled;
+    unsigned flags{ 0U };
+
+    states.next.clear();
+
+    for(int const current_state : states.current) {
+        auto const row = static_cast<std::size_t>(current_state);
+        auto const* const first =
+            program.transitions.data() + program.rows[row];
+        auto const* const last =
+            program.transitions.data() + program.rows[row + 1U];
+        bool matched{ false };
+
+        for(auto const* transition = first; transition != last; ++transition) {
+            if(transition->on != input) {
+                if(matched && program.grouped) {
+                    break;
+                }
+                continue;
+            }
+
+            matched = true;
+            for(int const state : program.closures.of(transition->to)) {
+                if(!this->is_dead(state) && states.next.insert(state)) {
+                    flags |=
+                        program.attributes[static_cast<std::size_t>(state)];
+                }
+            }
         }
     }
 
-    /*
-    std::cout << "After removal: \n";
-    this->print_enclosing(enclosing);
-    std::cout << std::endl;
-    */
+    std::swap(states.current, states.next);
 
-    this->build_nfa(result, enclosing, identical_states);
+    return !states.current.empty() &&
+           (flags & impl::attribute::accept_all) == 0U;
+}
 
-    return result;
+auto lnfa::is_accepting(run_state const& states) const noexcept -> bool
+{
+    return std::any_of(
+        states.current.begin(), states.current.end(), [this](int const state) {
+            return (m_compiled->attributes[static_cast<std::size_t>(state)] &
+                    impl::attribute::accepting) != 0U;
+        });
 }
 
 } // namespace fsm
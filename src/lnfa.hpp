@@ -2,12 +2,17 @@
 #define LAMBDA_NFA_HPP
 #pragma once
 
+#include "attributes.hpp"
+#include "closure.hpp"
 #include "fsm.hpp"
 #include "fsm_builder.hpp"
+#include "sparse_set.hpp"
 
 #include <map>
+#include <memory>
 #include <set>
 #include <utility>
+#include <vector>
 
 namespace fsm {
 
@@ -15,15 +20,48 @@ inline constexpr char lambda = '\0';
 
 class lnfa final : public automaton
 {
+public:
+    // Active states, and room for the next ones: a step fills `next` and
+    // swaps the two, so matching allocates nothing
+    class run_state
+    {
+    public:
+        impl::sparse_set current{};
+        impl::sparse_set next{};
+    };
+
 private:
-    builder m_builder{};
-    std::vector<int> m_current_states{};
+    // Never changes after construction, shared by all the copies
+    class compiled
+    {
+    public:
+        builder build{};
+        // impl::attribute flags, indexed by state
+        std::vector<std::uint8_t> attributes{};
+        impl::lambda_closures closures{};
+        // transitions on a byte are contiguous, see optimize()
+        bool grouped{ false };
+        // the transitions of `state` are transitions[rows[state]] up to
+        // transitions[rows[state + 1]], so a step looks nothing up
+        std::vector<impl::transition> transitions{};
+        std::vector<std::size_t> rows{};
+
+        explicit compiled(builder&& source);
+    };
+
+    // Program of a default-constructed lnfa, compiled once
+    [[nodiscard]] static auto empty_program()
+        -> std::shared_ptr<compiled const> const&;
+
+    std::shared_ptr<compiled const> m_compiled{ empty_program() };
+    // Always closed under lambda transitions
+    run_state m_current_states{};
     // Final states after lambda enclosing
     std::set<int> m_all_final_states{};
     bool m_aborted{ false };
 
-    auto check_lambda(std::set<int>& to_check, int const state) -> void;
-    [[nodiscard]] auto lambda_suffix(int const from) -> std::set<int>;
+    [[nodiscard]] auto is_dead(int const state) const noexcept -> bool;
+    [[nodiscard]] auto lambda_suffix(int const from) const -> std::set<int>;
     [[nodiscard]] auto can_go_to(std::set<int> const& input,
                                  char const on) const -> std::set<int>;
     auto
@@ -31,12 +69,10 @@ private:
         -> void;
     [[nodiscard]] auto get_identical_states(
         std::map<char, std::vector<std::set<int>>> const& enclosing) const
-        -> std::set<int>;
-    static auto rename_redundant_states(std::set<int>& input,
-                                        std::set<int> const& redundant) -> void;
+        -> std::vector<int>;
     auto build_nfa(builder& build,
                    std::map<char, std::vector<std::set<int>>> const& enclosing,
-                   std::set<int> const& redundant) -> void;
+                   std::vector<int> const& classes) -> void;
 
 public:
     lnfa() = default;
@@ -45,7 +81,7 @@ public:
     ~lnfa() noexcept override = default;
 
     explicit lnfa(builder const& build);
-    explicit lnfa(builder&& build) noexcept;
+    explicit lnfa(builder&& build);
 
     auto operator=(lnfa const&) -> lnfa& = default;
     auto operator=(lnfa&&) noexcept -> lnfa& = default;
@@ -58,6 +94,11 @@ public:
     auto print_transitions() -> void override;
 
     [[nodiscard]] auto to_nfa() -> builder;
+
+    [[nodiscard]] auto initial() const -> run_state;
+    [[nodiscard]] auto step(run_state& states, char const input) const -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& states) const noexcept
+        -> bool;
 };
 
 } // namespace fsm
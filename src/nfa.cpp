@@ -1,5 +1,7 @@
 #include "nfa.hpp"
 #include "printer.hpp"
+#include "profile.hpp"
+#include "trace.hpp"
 #include "transition.hpp"
 
 #include <algorithm>
@@ -10,37 +12,29 @@
 
 namespace fsm {
 
+nfa::compiled::compiled(builder&& source)
+    : build{ std::move(source) }
+    , attributes{ impl::compute_attributes(build) }
+    , grouped{ impl::grouped_by_byte(build) }
+{
+}
+
 nfa::nfa(builder const& build)
-    : m_builder{ build }
+    : m_compiled{ std::make_shared<compiled const>(builder{ build }) }
 {
-    m_current_states.push_back(m_builder.get_starting_state());
+    m_current_states.push_back(build.get_starting_state());
 }
 
-nfa::nfa(builder&& build) noexcept
-    : m_builder{ std::move(build) }
+nfa::nfa(builder&& build)
+    : m_compiled{ std::make_shared<compiled const>(std::move(build)) }
 {
-    m_current_states.push_back(m_builder.get_starting_state());
+    m_current_states.push_back(m_compiled->build.get_starting_state());
 }
 
 auto nfa::next(char const input) -> void
 {
-    std::set<int> next_states{};
-    auto const& autom = m_builder.get_configuration();
-
-    for(int const current_state : m_current_states) {
-        for(auto const& transition : autom.at(current_state)) {
-            if(transition.on == input) {
-                next_states.insert(transition.to);
-            }
-        }
-    }
-
-    if(next_states.empty()) {
-        m_aborted = true;
-    }
-
-    m_current_states.clear();
-    m_current_states.assign(next_states.begin(), next_states.end());
+    m_aborted = !this->step(m_current_states, input) &&
+                !this->is_accepting(m_current_states);
 }
 
 auto nfa::aborted() const noexcept -> bool
@@ -50,17 +44,7 @@ auto nfa::aborted() const noexcept -> bool
 
 auto nfa::accepted() const noexcept -> bool
 {
-    auto const& accepting_states = m_builder.get_accepting_states();
-
-    for(int const state : m_current_states) {
-        auto it =
-            std::find(accepting_states.begin(), accepting_states.end(), state);
-        if(it != accepting_states.end()) {
-            return true;
-        }
-    }
-
-    return false;
+    return this->is_accepting(m_current_states);
 }
 
 auto nfa::accepts_lambda() noexcept -> bool
@@ -71,16 +55,16 @@ auto nfa::accepts_lambda() noexcept -> bool
 auto nfa::reset() -> void
 {
     m_current_states.clear();
-    m_current_states.push_back(m_builder.get_starting_state());
+    m_current_states.push_back(m_compiled->build.get_starting_state());
     m_aborted = false;
 }
 
 auto nfa::print_transitions() -> void
 {
-    auto const& autom = m_builder.get_configuration();
+    auto const& autom = m_compiled->build.get_configuration();
 
     std::cout << "Final states: [ ";
-    for(int const final_state : m_builder.get_accepting_states()) {
+    for(int const final_state : m_compiled->build.get_accepting_states()) {
         std::cout << final_state << ' ';
     }
     std::cout << "]\n";
@@ -95,184 +79,147 @@ auto nfa::print_transitions() -> void
 auto nfa::to_dfa() -> builder
 {
     builder result{};
-    auto const& autom = m_builder.get_configuration();
-    std::deque<std::set<int>> additional_states{};
-    std::map<int, std::map<char, std::set<int>>> new_autom{};
-    int max_state{ 0 };
-    int max_state_copy{ 0 };
-
-    auto already_seen = [&additional_states](std::set<int> const& set) {
-        return std::find(additional_states.begin(),
-                         additional_states.end(),
-                         set) != additional_states.end();
-    };
+    auto const& build = m_compiled->build;
+    auto const& autom = build.get_configuration();
+    auto const& accepting_states = build.get_accepting_states();
+    auto const alphabet = build.get_alphabet();
 
-    for(auto const& [state, transitions] : autom) {
-        if(state > max_state) {
-            max_state = state;
-            max_state_copy = max_state;
-        }
-
-        for(char const ch : m_builder.get_alphabet()) {
-            std::set<int> path{};
-
-            for(auto const& transition : transitions) {
-                if(transition.on == ch) {
-                    path.insert(transition.to);
-                }
-            }
+    trace::scope subset_phase{ trace::phase::subset_construction,
+                               autom.size() };
 
-            if(path.size() > 1U && !already_seen(path)) {
-                additional_states.push_back(path);
-            }
+    // a subset of a single state keeps the id of that state, the bigger ones
+    // are numbered after every state of the NFA
+    int max_state{ build.get_starting_state() };
+    for(auto const& [state, transitions] : autom) {
+        max_state = std::max(max_state, state);
 
-            new_autom[state][ch] = path;
+        for(auto const& transition : transitions) {
+            max_state = std::max(max_state, transition.to);
         }
     }
 
-    /*
-    std::cout << "\nAdditional states:\n";
-    for(auto const& set : additional_states) {
-        print(set);
-        std::cout << ' ';
-    }
-    std::cout << std::endl << std::endl;
+    int next_id{ max_state + 1 };
+    std::map<std::set<int>, int> ids{};
+    std::deque<std::set<int>> queue{};
 
-    std::cout << "New autom:\n";
-    for(auto const& [state, transitions] : new_autom) {
-        std::cout << state << ":\n";
+    auto index = [&](std::set<int> const& subset) -> int {
+        auto const found = ids.find(subset);
+        if(found != ids.end()) {
+            return found->second;
+        }
 
-        for(auto const& [ch, path] : transitions) {
-            std::cout << ch << " -> ";
-            print(path);
-            std::cout << std::endl;
+        int const id = subset.size() == 1U ? *subset.begin() : next_id++;
+        ids.emplace(subset, id);
+        queue.push_back(subset);
+
+        bool const final = std::any_of(
+            subset.begin(), subset.end(), [&](int const state) {
+                return std::find(accepting_states.begin(),
+                                 accepting_states.end(),
+                                 state) != accepting_states.end();
+            });
+        if(final) {
+            result.set_accepting_state(id);
         }
-    }
-    std::cout << std::endl;
-    */
 
-    std::deque<std::set<int>> additional_states_copy{ additional_states };
+        return id;
+    };
+
+    result.set_starting_state(index({ build.get_starting_state() }));
 
-    while(!additional_states_copy.empty()) {
-        auto const& to_check = additional_states_copy.front();
-        ++max_state;
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const subset = queue.front();
+        int const from = ids.at(subset);
 
-        for(char const ch : m_builder.get_alphabet()) {
+        for(char const ch : alphabet) {
             std::set<int> path{};
-            for(int const state : to_check) {
-                for(auto const& transition : autom.at(state)) {
+
+            for(int const state : subset) {
+                auto const it = autom.find(state);
+                if(it == autom.end()) {
+                    continue;
+                }
+
+                for(auto const& transition : it->second) {
                     if(transition.on == ch) {
                         path.insert(transition.to);
                     }
                 }
             }
 
-            if(path.size() > 1U && !already_seen(path)) {
-                additional_states.push_back(path);
-                additional_states_copy.push_back(path);
+            if(!path.empty()) {
+                result.add_transition(from, ch, index(path));
             }
-
-            new_autom[max_state][ch] = path;
         }
-
-        additional_states_copy.pop_front();
-    }
-
-    /*
-    std::cout << "\nAdditional states:\n";
-    for(auto const& set : additional_states) {
-        print(set);
-        std::cout << ' ';
     }
-    std::cout << std::endl << std::endl;
-    */
 
-    auto index = [&additional_states,
-                  max_state_copy](std::set<int> const& state) -> int {
-        if(state.empty()) {
-            return -1;
-        }
-        if(state.size() == 1U) {
-            return *state.begin();
-        }
-        auto it = std::find(
-            additional_states.begin(), additional_states.end(), state);
-
-        return static_cast<int>(std::distance(additional_states.begin(), it)) +
-               max_state_copy + 1;
-    };
+    subset_phase.set_states_out(ids.size());
 
-    /*
-    std::cout << "New autom:\n";
-    for(auto const& [state, transitions] : new_autom) {
-        std::cout << state << ":\n";
+    return result;
+}
 
-        for(auto const& [ch, path] : transitions) {
-            std::cout << ch << " -> ";
-            if(path.empty()) {
-                std::cout << "{}";
-            }
-            else if(path.size() == 1U) {
-                std::cout << *path.begin();
-            }
-            else {
-                std::cout << index(path);
-            }
-            // print(path);
-            std::cout << std::endl;
-        }
-    }
-    std::cout << std::endl;
-    */
+auto nfa::is_dead(int const state) const noexcept -> bool
+{
+    return (m_compiled->attributes[static_cast<std::size_t>(state)] &
+            impl::attribute::dead) != 0U;
+}
 
-    auto is_final = [this](std::set<int> const& set) -> bool {
-        auto const& accepting_states = m_builder.get_accepting_states();
-        for(int const state : set) {
-            auto it = std::find(
-                accepting_states.begin(), accepting_states.end(), state);
+auto nfa::accepts_all(std::vector<int> const& states) const noexcept -> bool
+{
+    return std::any_of(states.begin(), states.end(), [this](int const state) {
+        return (m_compiled->attributes[static_cast<std::size_t>(state)] &
+                impl::attribute::accept_all) != 0U;
+    });
+}
 
-            if(it != accepting_states.end()) {
-                return true;
-            }
-        }
+auto nfa::initial() const -> run_state
+{
+    return run_state{ m_compiled->build.get_starting_state() };
+}
 
-        return false;
-    };
+auto nfa::step(run_state& states, char const input) const -> bool
+{
+    run_state next_states{};
+    auto const& autom = m_compiled->build.get_configuration();
 
-    result.set_starting_state(m_builder.get_starting_state());
+    for(int const current_state : states) {
+        auto const it = autom.find(current_state);
 
-    auto const& old_final_states = m_builder.get_accepting_states();
-    std::set<int> new_final_states{};
+        if(it == autom.end()) {
+            continue;
+        }
 
-    if(!old_final_states.empty()) {
-        new_final_states.insert(old_final_states.begin(),
-                                old_final_states.end());
-    }
+        bool matched{ false };
 
-    for(auto const& [state, transitions] : new_autom) {
-        for(auto const& [ch, path] : transitions) {
-            if(path.size() > 1U && is_final(path)) {
-                new_final_states.insert(state);
+        for(auto const& transition : it->second) {
+            if(transition.on != input) {
+                if(matched && m_compiled->grouped) {
+                    break;
+                }
+                continue;
             }
 
-            auto const idx = index(path);
-            if(idx > 0) {
-                result.add_transition(state, ch, idx);
+            matched = true;
+            if(!this->is_dead(transition.to)) {
+                next_states.push_back(transition.to);
             }
         }
     }
 
-    /*
-    std::cout << "New final states: ";
-    print(new_final_states);
-    std::cout << std::endl;
-    */
+    std::sort(next_states.begin(), next_states.end());
+    next_states.erase(std::unique(next_states.begin(), next_states.end()),
+                      next_states.end());
+    states.swap(next_states);
 
-    for(auto const& final_state : new_final_states) {
-        result.set_accepting_state(final_state);
-    }
+    return !states.empty() && !this->accepts_all(states);
+}
 
-    return result;
+auto nfa::is_accepting(run_state const& states) const noexcept -> bool
+{
+    return std::any_of(states.begin(), states.end(), [this](int const state) {
+        return (m_compiled->attributes[static_cast<std::size_t>(state)] &
+                impl::attribute::accepting) != 0U;
+    });
 }
 
 } // namespace fsm
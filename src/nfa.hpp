@@ -2,10 +2,12 @@
 #define NFA_HPP
 #pragma once
 
+#include "attributes.hpp"
 #include "fsm.hpp"
 #include "fsm_builder.hpp"
 #include "lnfa.hpp"
 
+#include <memory>
 #include <vector>
 
 namespace fsm {
@@ -13,10 +15,27 @@ namespace fsm {
 class nfa final : public automaton
 {
 private:
-    builder m_builder{};
+    // Never changes after construction, shared by all the copies
+    class compiled
+    {
+    public:
+        builder build{};
+        // impl::attribute flags, indexed by state
+        std::vector<std::uint8_t> attributes{};
+        // transitions on a byte are contiguous, see optimize()
+        bool grouped{ false };
+
+        explicit compiled(builder&& source);
+    };
+
+    std::shared_ptr<compiled const> m_compiled{};
     std::vector<int> m_current_states{};
     bool m_aborted{ false };
 
+    [[nodiscard]] auto is_dead(int const state) const noexcept -> bool;
+    [[nodiscard]] auto accepts_all(std::vector<int> const& states) const
+        noexcept -> bool;
+
 public:
     nfa() = delete;
     nfa(nfa const&) = default;
@@ -24,7 +43,7 @@ public:
     ~nfa() noexcept override = default;
 
     explicit nfa(builder const& build);
-    explicit nfa(builder&& build) noexcept;
+    explicit nfa(builder&& build);
 
     auto operator=(nfa const&) -> nfa& = default;
     auto operator=(nfa&&) noexcept -> nfa& = default;
@@ -37,6 +56,13 @@ public:
     auto print_transitions() -> void override;
 
     [[nodiscard]] auto to_dfa() -> builder;
+
+    using run_state = std::vector<int>;
+
+    [[nodiscard]] auto initial() const -> run_state;
+    [[nodiscard]] auto step(run_state& states, char const input) const -> bool;
+    [[nodiscard]] auto is_accepting(run_state const& states) const noexcept
+        -> bool;
 };
 
 } // namespace fsm
@@ -0,0 +1,109 @@
+#include "pipeline.hpp"
+
+#include <algorithm>
+
+namespace fsm::impl {
+
+auto read_chunks(std::istream& input,
+                 std::size_t const buffer_size,
+                 bounded_queue<chunk>& out) -> void
+{
+    std::string carry{};
+    std::size_t sequence{ 0 };
+    std::size_t line{ 0 };
+
+    auto const emit = [&](std::string bytes) -> bool {
+        auto const lines = std::count(bytes.begin(), bytes.end(), '\n');
+        chunk next{ sequence++, line, std::move(bytes) };
+
+        line += static_cast<std::size_t>(lines);
+        return out.push(std::move(next));
+    };
+
+    while(input) {
+        std::string buffer{ std::move(carry) };
+        auto const kept = buffer.size();
+
+        buffer.resize(kept + buffer_size);
+        input.read(&buffer[kept], static_cast<std::streamsize>(buffer_size));
+        buffer.resize(kept + static_cast<std::size_t>(input.gcount()));
+
+        // a line longer than a buffer is carried over until it ends
+        auto const last = buffer.rfind('\n');
+        if(last == std::string::npos) {
+            carry = std::move(buffer);
+            continue;
+        }
+
+        carry = buffer.substr(last + 1U);
+        buffer.resize(last + 1U);
+        if(!emit(std::move(buffer))) {
+            return;
+        }
+    }
+
+    if(input.bad()) {
+        throw std::runtime_error{ "reading the input failed" };
+    }
+    if(!carry.empty()) {
+        emit(std::move(carry));
+    }
+}
+
+reorder_window::reorder_window(std::size_t const capacity)
+    : m_capacity{ capacity }
+{
+    if(capacity == 0U) {
+        throw std::invalid_argument{ "a window holds at least one chunk" };
+    }
+}
+
+auto reorder_window::enter(std::size_t const sequence) -> bool
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_moved.wait(lock, [&] {
+        return m_closed || sequence < m_next + m_capacity;
+    });
+
+    return !m_closed;
+}
+
+auto reorder_window::advance(std::size_t const next) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_next = next;
+    }
+
+    m_moved.notify_all();
+}
+
+auto reorder_window::close() -> void
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_closed = true;
+    }
+
+    m_moved.notify_all();
+}
+
+auto first_error::set(std::exception_ptr error) -> void
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    if(!m_error) {
+        m_error = std::move(error);
+    }
+}
+
+auto first_error::rethrow() -> void
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+
+    if(m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+} // namespace fsm::impl
@@ -0,0 +1,361 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+#pragma once
+
+#include "cursor.hpp"
+#include "fsm.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fsm {
+
+class pipeline_options
+{
+public:
+    // bytes the reader asks for at once, buffers are cut after their last line
+    std::size_t buffer_size{ 1U << 16U };
+    // buffers waiting between two stages before the earlier one blocks
+    std::size_t queue_capacity{ 8U };
+    // threads matching buffers
+    std::size_t matchers{ 2U };
+};
+
+class pipeline_stats
+{
+public:
+    std::size_t lines{ 0 };
+    std::size_t accepted{ 0 };
+    std::size_t bytes{ 0 };
+    std::size_t buffers{ 0 };
+};
+
+// Queue between two pipeline stages: a stage pushing to a full queue waits for
+// the next one to catch up, so no stage runs arbitrarily far ahead
+template<typename T>
+class bounded_queue
+{
+private:
+    std::mutex m_mutex{};
+    std::condition_variable m_not_full{};
+    std::condition_variable m_not_empty{};
+    std::deque<T> m_items{};
+    std::size_t m_capacity{ 1 };
+    bool m_closed{ false };
+
+public:
+    bounded_queue() = delete;
+    bounded_queue(bounded_queue const&) = delete;
+    bounded_queue(bounded_queue&&) = delete;
+    ~bounded_queue() noexcept = default;
+
+    // Throws std::invalid_argument if `capacity` is 0
+    explicit bounded_queue(std::size_t const capacity);
+
+    auto operator=(bounded_queue const&) -> bounded_queue& = delete;
+    auto operator=(bounded_queue&&) -> bounded_queue& = delete;
+
+    // Waits while the queue is full, false if it is closed
+    auto push(T item) -> bool;
+    // Waits while the queue is empty and open, std::nullopt once it is closed
+    // and every item was popped
+    [[nodiscard]] auto pop() -> std::optional<T>;
+    // Wakes up everyone waiting, nothing can be pushed anymore
+    auto close() -> void;
+};
+
+namespace impl {
+
+// Whole lines of the input, the last one may lack its newline
+class chunk
+{
+public:
+    std::size_t sequence{ 0 };
+    std::size_t first_line{ 0 };
+    std::string bytes{};
+};
+
+class chunk_verdicts
+{
+public:
+    std::size_t sequence{ 0 };
+    std::size_t first_line{ 0 };
+    std::size_t bytes{ 0 };
+    std::vector<bool> accepted{};
+};
+
+// Reader stage: pushes `input` as chunks until it ends or `out` is closed.
+// Throws std::runtime_error if reading fails.
+auto read_chunks(std::istream& input,
+                 std::size_t const buffer_size,
+                 bounded_queue<chunk>& out) -> void;
+
+// First exception thrown by any stage, rethrown once they are all done
+class first_error
+{
+private:
+    std::mutex m_mutex{};
+    std::exception_ptr m_error{};
+
+public:
+    auto set(std::exception_ptr error) -> void;
+    auto rethrow() -> void;
+};
+
+// Keeps matchers at most `capacity` chunks ahead of the sink, so the verdicts
+// waiting for a slow chunk before them stay few
+class reorder_window
+{
+private:
+    std::mutex m_mutex{};
+    std::condition_variable m_moved{};
+    std::size_t m_next{ 0 };
+    std::size_t m_capacity{ 1 };
+    bool m_closed{ false };
+
+public:
+    reorder_window() = delete;
+    reorder_window(reorder_window const&) = delete;
+    reorder_window(reorder_window&&) = delete;
+    ~reorder_window() noexcept = default;
+
+    // Throws std::invalid_argument if `capacity` is 0
+    explicit reorder_window(std::size_t const capacity);
+
+    auto operator=(reorder_window const&) -> reorder_window& = delete;
+    auto operator=(reorder_window&&) -> reorder_window& = delete;
+
+    // Waits while chunk `sequence` is too far ahead of the sink, false if the
+    // window is closed
+    auto enter(std::size_t const sequence) -> bool;
+    // The sink is done with every chunk before `next`
+    auto advance(std::size_t const next) -> void;
+    // Wakes up everyone waiting, nothing can enter anymore
+    auto close() -> void;
+};
+
+template<typename Engine>
+[[nodiscard]] auto match_chunk(cursor<Engine>& matcher, chunk const& lines)
+    -> chunk_verdicts
+{
+    std::string_view const bytes{ lines.bytes };
+    chunk_verdicts result{ lines.sequence, lines.first_line, bytes.size(), {} };
+
+    for(std::size_t begin = 0; begin < bytes.size();) {
+        auto end = bytes.find('\n', begin);
+        end = end == std::string_view::npos ? bytes.size() : end;
+
+        matcher.reset();
+        matcher.feed(bytes.substr(begin, end - begin));
+        result.accepted.push_back(matcher.accepted());
+        begin = end + 1U;
+    }
+
+    return result;
+}
+
+} // namespace impl
+
+// Matches every line of `input` on its own, calling sink(line, accepted) for
+// each of them in order, line numbers starting from 0.
+//
+// A reader thread cuts the input into buffers of whole lines, a pool of
+// `options.matchers` threads match them with a cursor each, and the calling
+// thread hands the verdicts to the sink in input order. Reading overlaps
+// matching, and bounded queues between the stages keep at most a few buffers
+// in flight however fast the input comes: matchers don't start a buffer more
+// than `options.queue_capacity` buffers ahead of the sink either.
+//
+// Throws std::invalid_argument if the options ask for no buffer, queue or
+// matcher, and whatever a stage throws, once every stage has stopped.
+template<typename Engine, typename Sink>
+auto match_lines(std::shared_ptr<Engine const> engine,
+                 std::istream& input,
+                 Sink&& sink,
+                 pipeline_options const& options = {}) -> pipeline_stats;
+
+template<typename T>
+bounded_queue<T>::bounded_queue(std::size_t const capacity)
+    : m_capacity{ capacity }
+{
+    if(capacity == 0U) {
+        throw std::invalid_argument{ "a queue holds at least one item" };
+    }
+}
+
+template<typename T>
+auto bounded_queue<T>::push(T item) -> bool
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_not_full.wait(
+        lock, [this] { return m_closed || m_items.size() < m_capacity; });
+
+    if(m_closed) {
+        return false;
+    }
+
+    m_items.push_back(std::move(item));
+    lock.unlock();
+    m_not_empty.notify_one();
+
+    return true;
+}
+
+template<typename T>
+auto bounded_queue<T>::pop() -> std::optional<T>
+{
+    std::unique_lock<std::mutex> lock{ m_mutex };
+    m_not_empty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+
+    if(m_items.empty()) {
+        return std::nullopt;
+    }
+
+    std::optional<T> item{ std::move(m_items.front()) };
+    m_items.pop_front();
+    lock.unlock();
+    m_not_full.notify_one();
+
+    return item;
+}
+
+template<typename T>
+auto bounded_queue<T>::close() -> void
+{
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_closed = true;
+    }
+
+    m_not_full.notify_all();
+    m_not_empty.notify_all();
+}
+
+template<typename Engine, typename Sink>
+auto match_lines(std::shared_ptr<Engine const> engine,
+                 std::istream& input,
+                 Sink&& sink,
+                 pipeline_options const& options) -> pipeline_stats
+{
+    if(options.buffer_size == 0U || options.matchers == 0U) {
+        throw std::invalid_argument{
+            "a pipeline reads some bytes and has a matcher at least"
+        };
+    }
+
+    bounded_queue<impl::chunk> chunks{ options.queue_capacity };
+    bounded_queue<impl::chunk_verdicts> verdicts{ options.queue_capacity };
+    impl::reorder_window window{ options.queue_capacity };
+    impl::first_error error{};
+    std::atomic<std::size_t> running{ options.matchers };
+    std::vector<std::thread> stages{};
+
+    auto const stop = [&] {
+        chunks.close();
+        verdicts.close();
+        window.close();
+    };
+    auto const fail = [&](std::exception_ptr thrown) {
+        error.set(std::move(thrown));
+        stop();
+    };
+
+    // threads already running are stopped and joined if another can't start
+    try {
+        stages.reserve(options.matchers + 1U);
+
+        stages.emplace_back([&] {
+            try {
+                impl::read_chunks(input, options.buffer_size, chunks);
+            }
+            catch(...) {
+                fail(std::current_exception());
+            }
+            chunks.close();
+        });
+
+        for(std::size_t i = 0; i < options.matchers; ++i) {
+            stages.emplace_back([&] {
+                try {
+                    cursor<Engine> matcher{ engine };
+
+                    while(auto const lines = chunks.pop()) {
+                        if(!window.enter(lines->sequence) ||
+                           !verdicts.push(impl::match_chunk(matcher, *lines))) {
+                            break;
+                        }
+                    }
+                }
+                catch(...) {
+                    fail(std::current_exception());
+                }
+
+                if(running.fetch_sub(1U) == 1U) {
+                    verdicts.close();
+                }
+            });
+        }
+    }
+    catch(...) {
+        stop();
+        for(auto& stage : stages) {
+            stage.join();
+        }
+        throw;
+    }
+
+    pipeline_stats stats{};
+
+    // sink stage, buffers matched out of order wait for the ones before them
+    try {
+        std::map<std::size_t, impl::chunk_verdicts> pending{};
+
+        while(auto done = verdicts.pop()) {
+            pending.emplace(done->sequence, std::move(*done));
+
+            for(auto it = pending.find(stats.buffers); it != pending.end();
+                it = pending.find(stats.buffers)) {
+                auto const& matched = it->second;
+
+                for(std::size_t i = 0; i < matched.accepted.size(); ++i) {
+                    sink(matched.first_line + i, matched.accepted[i]);
+                    stats.accepted += matched.accepted[i] ? 1U : 0U;
+                }
+
+                stats.lines += matched.accepted.size();
+                stats.bytes += matched.bytes;
+                ++stats.buffers;
+                pending.erase(it);
+                window.advance(stats.buffers);
+            }
+        }
+    }
+    catch(...) {
+        fail(std::current_exception());
+    }
+
+    for(auto& stage : stages) {
+        stage.join();
+    }
+    error.rethrow();
+
+    return stats;
+}
+
+} // namespace fsm
+
+#endif // !PIPELINE_HPP
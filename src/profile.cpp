@@ -0,0 +1,168 @@
+#include "profile.hpp"
+#include "closure.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <utility>
+
+namespace fsm {
+
+auto profile(builder const& build, std::vector<std::string> const& corpus)
+    -> transition_profile
+{
+    impl::lambda_closures const closures{ build };
+    auto const& autom = build.get_configuration();
+    transition_profile result{};
+
+    for(auto const& [state, transitions] : autom) {
+        result.hits[state].assign(transitions.size(), 0U);
+    }
+
+    for(auto const& input : corpus) {
+        auto const start = closures.of(build.get_starting_state());
+        std::vector<int> states(start.begin(), start.end());
+
+        for(char const ch : input) {
+            std::vector<int> next_states{};
+
+            for(int const state : states) {
+                ++result.visits[state];
+
+                auto const it = autom.find(state);
+                if(it == autom.end()) {
+                    continue;
+                }
+
+                auto& hits = result.hits[state];
+                for(std::size_t i = 0; i < it->second.size(); ++i) {
+                    if(it->second[i].on != ch) {
+                        continue;
+                    }
+
+                    ++hits[i];
+                    auto const reached = closures.of(it->second[i].to);
+                    next_states.insert(
+                        next_states.end(), reached.begin(), reached.end());
+                }
+            }
+
+            std::sort(next_states.begin(), next_states.end());
+            next_states.erase(
+                std::unique(next_states.begin(), next_states.end()),
+                next_states.end());
+            states.swap(next_states);
+
+            if(states.empty()) {
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+auto optimize(builder const& build, transition_profile const& profile)
+    -> builder
+{
+    auto const& autom = build.get_configuration();
+    auto const n = impl::state_count(build);
+
+    auto const visits_of = [&profile](int const state) -> std::size_t {
+        auto const it = profile.visits.find(state);
+        return it == profile.visits.end() ? 0U : it->second;
+    };
+
+    // most visited first, the others keep their relative order
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int const a, int const b) {
+        return visits_of(a) > visits_of(b);
+    });
+
+    std::vector<int> renumbered(n, 0);
+    for(std::size_t i = 0; i < n; ++i) {
+        renumbered[static_cast<std::size_t>(order[i])] = static_cast<int>(i);
+    }
+    auto const id = [&renumbered](int const state) -> int {
+        return renumbered[static_cast<std::size_t>(state)];
+    };
+
+    builder result{};
+    result.set_starting_state(id(build.get_starting_state()));
+    for(int const state : build.get_accepting_states()) {
+        result.set_accepting_state(id(state));
+    }
+
+    // added in the new order, so hot states are allocated together
+    for(int const state : order) {
+        auto const it = autom.find(state);
+        if(it == autom.end()) {
+            continue;
+        }
+
+        auto const& transitions = it->second;
+        auto const found = profile.hits.find(state);
+        std::vector<std::size_t> const no_hits(transitions.size(), 0U);
+        auto const& hits = found == profile.hits.end() ||
+                                   found->second.size() != transitions.size()
+                               ? no_hits
+                               : found->second;
+
+        // byte -> (hits of its group, position of its first transition)
+        std::map<char, std::pair<std::size_t, std::size_t>> groups{};
+        for(std::size_t i = 0; i < transitions.size(); ++i) {
+            auto& group =
+                groups.try_emplace(transitions[i].on, std::make_pair(0U, i))
+                    .first->second;
+            group.first += hits[i];
+        }
+
+        std::vector<char> bytes{};
+        for(auto const& [byte, group] : groups) {
+            bytes.push_back(byte);
+        }
+        std::sort(bytes.begin(), bytes.end(), [&](char const a, char const b) {
+            auto const& x = groups.at(a);
+            auto const& y = groups.at(b);
+            return x.first != y.first ? x.first > y.first : x.second < y.second;
+        });
+
+        for(char const byte : bytes) {
+            for(auto const& transition : transitions) {
+                if(transition.on == byte) {
+                    result.add_transition(
+                        id(state), transition.on, id(transition.to));
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+namespace impl {
+
+auto grouped_by_byte(builder const& build) -> bool
+{
+    for(auto const& [state, transitions] : build.get_configuration()) {
+        std::set<char> finished{};
+
+        for(std::size_t i = 0; i < transitions.size(); ++i) {
+            char const on = transitions[i].on;
+
+            if(finished.count(on) != 0U) {
+                return false;
+            }
+            if(i + 1U == transitions.size() || transitions[i + 1U].on != on) {
+                finished.insert(on);
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace impl
+
+} // namespace fsm
@@ -0,0 +1,49 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fsm {
+
+// How often the transitions of a builder are taken on sample inputs
+class transition_profile
+{
+public:
+    // state -> times each of its transitions was taken, in builder order
+    std::map<int, std::vector<std::size_t>> hits{};
+    // state -> steps it was active for, each one a scan of its transitions
+    std::map<int, std::size_t> visits{};
+};
+
+// Runs `build` the way lnfa does on every input of `corpus`, counting the
+// transitions taken
+[[nodiscard]] auto profile(builder const& build,
+                           std::vector<std::string> const& corpus)
+    -> transition_profile;
+
+// Same language, laid out for the traffic `profile` was gathered on:
+//  - the transitions of each state are grouped by byte, the group taken most
+//    often first, so nfa and lnfa stop scanning as soon as the group of the
+//    input byte ends
+//  - states are renumbered from the most visited one, and stored in that
+//    order, so the hot states and their transitions sit together
+[[nodiscard]] auto optimize(builder const& build,
+                            transition_profile const& profile) -> builder;
+
+namespace impl {
+
+// Whether the transitions on any one byte are next to each other in every
+// state, so a scan can stop at the end of the ones matching
+[[nodiscard]] auto grouped_by_byte(builder const& build) -> bool;
+
+} // namespace impl
+
+} // namespace fsm
+
+#endif // !PROFILE_HPP
@@ -0,0 +1,239 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+
+namespace fsm {
+
+// longest literal prefix the prefilter looks for
+static constexpr std::size_t max_prefix = 64U;
+
+searcher::searcher(dfa const& pattern)
+    : m_anchored{ pattern.table() }
+    , m_reverse{ pattern.reverse().table() }
+    , m_class_count{ pattern.table().class_count() }
+{
+    constexpr int dead = impl::dfa_table::dead;
+    constexpr std::size_t byte_count = 256U;
+    int const start = m_anchored.start();
+
+    // a byte standing for every equivalence class
+    std::vector<char> representative(m_class_count, '\0');
+    for(std::size_t byte = byte_count; byte-- > 0U;) {
+        auto const ch = static_cast<char>(static_cast<unsigned char>(byte));
+        representative[m_anchored.class_of(ch)] = ch;
+    }
+
+    // subset construction of the `.*`-prefixed automaton, every subset holds
+    // the starting state so a match can begin at any position
+    std::map<std::vector<int>, int> seen{};
+    std::deque<std::vector<int>> queue{};
+
+    auto add_subset = [&](std::vector<int> subset) -> int {
+        subset.push_back(start);
+        std::sort(subset.begin(), subset.end());
+        subset.erase(std::unique(subset.begin(), subset.end()), subset.end());
+
+        auto const [it, inserted] =
+            seen.try_emplace(subset, static_cast<int>(seen.size()));
+
+        if(inserted) {
+            bool const accepting =
+                std::any_of(subset.begin(), subset.end(), [this](int const s) {
+                    return m_anchored.accepting(s);
+                });
+
+            m_forward.resize(m_forward.size() + m_class_count, 0);
+            m_forward_accepting.push_back(accepting ? 1U : 0U);
+            queue.push_back(std::move(subset));
+        }
+
+        return it->second;
+    };
+
+    static_cast<void>(add_subset({}));
+
+    for(; !queue.empty(); queue.pop_front()) {
+        auto const subset = queue.front();
+        auto const from = static_cast<std::size_t>(seen.at(subset));
+
+        for(std::size_t cls = 0; cls < m_class_count; ++cls) {
+            std::vector<int> next{};
+
+            for(int const state : subset) {
+                int const to = m_anchored.step(state, representative[cls]);
+
+                if(to != dead) {
+                    next.push_back(to);
+                }
+            }
+
+            int const to = add_subset(std::move(next));
+            m_forward[from * m_class_count + cls] = to;
+        }
+    }
+
+    // literal prefix: follow the states with a single way out
+    for(int state = start;
+        !m_anchored.accepting(state) && m_prefix.size() < max_prefix;) {
+        int next = dead;
+        std::size_t ways_out{ 0 };
+        char last{ '\0' };
+
+        for(std::size_t byte = 0; byte < byte_count && ways_out < 2U; ++byte) {
+            auto const ch = static_cast<char>(static_cast<unsigned char>(byte));
+            int const to = m_anchored.step(state, ch);
+
+            if(to != dead) {
+                ++ways_out;
+                next = to;
+                last = ch;
+            }
+        }
+
+        if(ways_out != 1U) {
+            break;
+        }
+
+        m_prefix.push_back(last);
+        state = next;
+    }
+
+    for(std::size_t byte = 0; byte < byte_count; ++byte) {
+        auto const ch = static_cast<char>(static_cast<unsigned char>(byte));
+
+        if(m_anchored.step(start, ch) != dead) {
+            m_first_bytes[byte] = true;
+            ++m_first_byte_count;
+        }
+    }
+}
+
+auto searcher::candidate(std::string_view const text,
+                         std::size_t const from) const -> std::size_t
+{
+    if(from >= text.size()) {
+        return std::string_view::npos;
+    }
+    if(!m_prefix.empty()) {
+        return text.find(m_prefix, from);
+    }
+    if(m_first_byte_count == 0U) {
+        return std::string_view::npos;
+    }
+    if(m_first_byte_count == 1U) {
+        auto const byte = static_cast<int>(
+            std::find(m_first_bytes.begin(), m_first_bytes.end(), true) -
+            m_first_bytes.begin());
+        auto const* const found =
+            std::memchr(text.data() + from, byte, text.size() - from);
+
+        return found == nullptr
+                   ? std::string_view::npos
+                   : static_cast<std::size_t>(
+                         static_cast<char const*>(found) - text.data());
+    }
+
+    for(std::size_t i = from; i < text.size(); ++i) {
+        if(m_first_bytes[static_cast<unsigned char>(text[i])]) {
+            return i;
+        }
+    }
+
+    return std::string_view::npos;
+}
+
+auto searcher::match_start(std::string_view const text,
+                           std::size_t const from,
+                           std::size_t const end) const -> std::size_t
+{
+    std::size_t start = end;
+    int state = m_reverse.start();
+
+    for(std::size_t i = end; i > from;) {
+        state = m_reverse.step(state, text[--i]);
+
+        if(state == impl::dfa_table::dead) {
+            break;
+        }
+        if(m_reverse.accepting(state)) {
+            start = i;
+        }
+    }
+
+    return start;
+}
+
+auto searcher::find(std::string_view const text, std::size_t const from) const
+    -> std::optional<match>
+{
+    if(from > text.size()) {
+        return std::nullopt;
+    }
+    if(m_anchored.accepting(m_anchored.start())) {
+        return match{ from, from };
+    }
+
+    auto position = this->candidate(text, from);
+    if(position == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    // subset 0 is the starting state alone: nothing is being matched
+    constexpr int restart = 0;
+    int state = restart;
+    std::size_t scan_from = position;
+
+    for(std::size_t i = position; i < text.size(); ++i) {
+        auto const row = static_cast<std::size_t>(state) * m_class_count;
+        state = m_forward[row + m_anchored.class_of(text[i])];
+
+        if(m_forward_accepting[static_cast<std::size_t>(state)] != 0U) {
+            auto const end = i + 1U;
+            return match{ this->match_start(text, scan_from, end), end };
+        }
+
+        if(state == restart) {
+            position = this->candidate(text, i + 1U);
+
+            if(position == std::string_view::npos) {
+                return std::nullopt;
+            }
+
+            i = position - 1U;
+            scan_from = position;
+        }
+    }
+
+    return std::nullopt;
+}
+
+auto searcher::find_all(std::string_view const text) const
+    -> std::vector<match>
+{
+    std::vector<match> result{};
+    std::size_t position{ 0 };
+
+    for(auto found = this->find(text, position); found.has_value();
+        found = this->find(text, position)) {
+        result.push_back(*found);
+        // empty matches still have to move forward
+        position = found->end > found->start ? found->end : found->end + 1U;
+    }
+
+    return result;
+}
+
+auto searcher::contains(std::string_view const text) const -> bool
+{
+    return this->find(text).has_value();
+}
+
+auto searcher::prefix() const noexcept -> std::string const&
+{
+    return m_prefix;
+}
+
+} // namespace fsm
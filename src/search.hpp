@@ -0,0 +1,77 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+#pragma once
+
+#include "dfa.hpp"
+#include "dfa_table.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsm {
+
+class match
+{
+public:
+    std::size_t start{ 0 };
+    std::size_t end{ 0 };
+};
+
+// Finds occurrences of a DFA's language anywhere in a text.
+//
+// The text is scanned once by the `.*`-prefixed automaton, which is only
+// started at positions the prefilter accepts: the literal every match begins
+// with, or else the set of bytes a match can begin with. Once it finds where
+// a match ends, the DFA of the reversed language runs back from there to find
+// where it starts, so each byte is read at most twice.
+class searcher
+{
+private:
+    impl::dfa_table m_anchored{};
+    impl::dfa_table m_reverse{};
+    // Unanchored automaton, sharing the byte classes of m_anchored
+    std::vector<int> m_forward{};
+    std::vector<std::uint8_t> m_forward_accepting{};
+    std::size_t m_class_count{ 0 };
+
+    std::string m_prefix{};
+    std::array<bool, 256> m_first_bytes{};
+    std::size_t m_first_byte_count{ 0 };
+
+    [[nodiscard]] auto candidate(std::string_view const text,
+                                 std::size_t const from) const -> std::size_t;
+    [[nodiscard]] auto match_start(std::string_view const text,
+                                   std::size_t const from,
+                                   std::size_t const end) const -> std::size_t;
+
+public:
+    searcher() = delete;
+    searcher(searcher const&) = default;
+    searcher(searcher&&) noexcept = default;
+    ~searcher() noexcept = default;
+
+    explicit searcher(dfa const& pattern);
+
+    auto operator=(searcher const&) -> searcher& = default;
+    auto operator=(searcher&&) noexcept -> searcher& = default;
+
+    // The match ending first; of those ending there, the one starting first
+    [[nodiscard]] auto find(std::string_view const text,
+                            std::size_t const from = 0U) const
+        -> std::optional<match>;
+    // Non-overlapping matches, left to right
+    [[nodiscard]] auto find_all(std::string_view const text) const
+        -> std::vector<match>;
+    [[nodiscard]] auto contains(std::string_view const text) const -> bool;
+
+    [[nodiscard]] auto prefix() const noexcept -> std::string const&;
+};
+
+} // namespace fsm
+
+#endif // !SEARCH_HPP
@@ -0,0 +1,105 @@
+#ifndef SPARSE_SET_HPP
+#define SPARSE_SET_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fsm::impl {
+
+// Set of states 0..capacity - 1 (Briggs and Torczon): the members are listed
+// in `dense`, in the order they were inserted, and `sparse` maps a member to
+// its index there. Inserting, looking up and clearing take constant time, and
+// nothing is allocated once it is built.
+class sparse_set
+{
+private:
+    std::vector<int> m_dense{};
+    std::vector<std::uint32_t> m_sparse{};
+    std::size_t m_size{ 0 };
+
+public:
+    sparse_set() = default;
+    sparse_set(sparse_set const&) = default;
+    sparse_set(sparse_set&&) noexcept = default;
+    ~sparse_set() noexcept = default;
+
+    explicit sparse_set(std::size_t const capacity);
+
+    auto operator=(sparse_set const&) -> sparse_set& = default;
+    auto operator=(sparse_set&&) noexcept -> sparse_set& = default;
+
+    [[nodiscard]] auto contains(int const state) const noexcept -> bool;
+    // False if `state` was there already
+    auto insert(int const state) noexcept -> bool;
+    auto clear() noexcept -> void;
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t;
+    [[nodiscard]] auto empty() const noexcept -> bool;
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t;
+
+    [[nodiscard]] auto begin() const noexcept -> int const*;
+    [[nodiscard]] auto end() const noexcept -> int const*;
+};
+
+inline sparse_set::sparse_set(std::size_t const capacity)
+    : m_dense(capacity, 0)
+    , m_sparse(capacity, 0U)
+{
+}
+
+inline auto sparse_set::contains(int const state) const noexcept -> bool
+{
+    auto const index = m_sparse[static_cast<std::size_t>(state)];
+
+    return index < m_size && m_dense[index] == state;
+}
+
+inline auto sparse_set::insert(int const state) noexcept -> bool
+{
+    if(this->contains(state)) {
+        return false;
+    }
+
+    m_dense[m_size] = state;
+    m_sparse[static_cast<std::size_t>(state)] =
+        static_cast<std::uint32_t>(m_size);
+    ++m_size;
+
+    return true;
+}
+
+inline auto sparse_set::clear() noexcept -> void
+{
+    m_size = 0U;
+}
+
+inline auto sparse_set::size() const noexcept -> std::size_t
+{
+    return m_size;
+}
+
+inline auto sparse_set::empty() const noexcept -> bool
+{
+    return m_size == 0U;
+}
+
+inline auto sparse_set::capacity() const noexcept -> std::size_t
+{
+    return m_dense.size();
+}
+
+inline auto sparse_set::begin() const noexcept -> int const*
+{
+    return m_dense.data();
+}
+
+inline auto sparse_set::end() const noexcept -> int const*
+{
+    return m_dense.data() + m_size;
+}
+
+} // namespace fsm::impl
+
+#endif // !SPARSE_SET_HPP
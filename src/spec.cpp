@@ -0,0 +1,213 @@
+#include "spec.hpp"
+
+#include <cctype>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fsm {
+
+namespace {
+
+[[noreturn]] auto fail(std::size_t const line, std::string const& what)
+    -> void
+{
+    throw std::invalid_argument{ "spec line " + std::to_string(line) + ": " +
+                                 what };
+}
+
+[[nodiscard]] auto hex_digit(char const ch) -> int
+{
+    if(ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if(ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if(ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+
+    return -1;
+}
+
+// Byte at `position`, which is moved past it
+[[nodiscard]] auto read_byte(std::string const& token,
+                             std::size_t& position,
+                             std::size_t const line) -> unsigned char
+{
+    if(token.compare(position, 2U, "\\x") == 0 &&
+       position + 4U <= token.size()) {
+        int const high = hex_digit(token[position + 2U]);
+        int const low = hex_digit(token[position + 3U]);
+
+        if(high < 0 || low < 0) {
+            fail(line, "bad escape in '" + token + "'");
+        }
+
+        position += 4U;
+        return static_cast<unsigned char>(high * 16 + low);
+    }
+
+    return static_cast<unsigned char>(token[position++]);
+}
+
+[[nodiscard]] auto read_range(std::string const& token, std::size_t const line)
+    -> std::pair<unsigned char, unsigned char>
+{
+    std::size_t position{ 0 };
+    auto const first = read_byte(token, position, line);
+
+    if(position == token.size()) {
+        return { first, first };
+    }
+    if(token[position] != '-' || position + 1U == token.size()) {
+        fail(line, "bad byte range '" + token + "'");
+    }
+
+    ++position;
+    auto const last = read_byte(token, position, line);
+
+    if(position != token.size() || last < first) {
+        fail(line, "bad byte range '" + token + "'");
+    }
+
+    return { first, last };
+}
+
+[[nodiscard]] auto read_state(std::string const& token, std::size_t const line)
+    -> int
+{
+    std::size_t end{ 0 };
+    int state{ -1 };
+
+    try {
+        state = std::stoi(token, &end);
+    }
+    catch(std::exception const&) {
+        fail(line, "bad state '" + token + "'");
+    }
+
+    if(end != token.size() || state < 0) {
+        fail(line, "bad state '" + token + "'");
+    }
+
+    return state;
+}
+
+auto write_byte(std::ostream& out, unsigned char const byte) -> void
+{
+    constexpr char const* digits = "0123456789abcdef";
+
+    if(std::isalnum(byte) != 0 || byte == '_') {
+        out << static_cast<char>(byte);
+        return;
+    }
+
+    out << "\\x" << digits[byte / 16U] << digits[byte % 16U];
+}
+
+} // namespace
+
+auto read_spec(std::istream& in) -> builder
+{
+    builder result{};
+    std::string text{};
+
+    for(std::size_t line = 1; std::getline(in, text); ++line) {
+        text = text.substr(0, text.find('#'));
+
+        std::istringstream words{ text };
+        std::string first{};
+
+        if(!(words >> first)) {
+            continue;
+        }
+
+        std::string word{};
+
+        if(first == "start") {
+            if(!(words >> word)) {
+                fail(line, "missing starting state");
+            }
+            result.set_starting_state(read_state(word, line));
+        }
+        else if(first == "accept") {
+            while(words >> word) {
+                result.set_accepting_state(read_state(word, line));
+            }
+        }
+        else {
+            std::string bytes{};
+
+            if(!(words >> bytes >> word)) {
+                fail(line, "expected '<from> <bytes> <to>'");
+            }
+
+            int const from = read_state(first, line);
+            int const to = read_state(word, line);
+            auto const [low, high] = read_range(bytes, line);
+
+            for(unsigned byte = low; byte <= high; ++byte) {
+                result.add_transition(
+                    from, static_cast<char>(static_cast<unsigned char>(byte)),
+                    to);
+            }
+        }
+
+        if(words >> word) {
+            fail(line, "unexpected '" + word + "'");
+        }
+    }
+
+    return result;
+}
+
+auto write_spec(std::ostream& out, builder const& build) -> void
+{
+    out << "start " << build.get_starting_state() << '\n';
+
+    std::set<int> const accepting(build.get_accepting_states().begin(),
+                                  build.get_accepting_states().end());
+    if(!accepting.empty()) {
+        out << "accept";
+        for(int const state : accepting) {
+            out << ' ' << state;
+        }
+        out << '\n';
+    }
+
+    for(auto const& [from, transitions] : build.get_configuration()) {
+        // (to, byte), so the bytes going to the same state are next to
+        // each other
+        std::set<std::pair<int, unsigned>> sorted{};
+
+        for(auto const& transition : transitions) {
+            sorted.emplace(transition.to,
+                           static_cast<unsigned char>(transition.on));
+        }
+
+        for(auto it = sorted.begin(); it != sorted.end();) {
+            auto const [to, first] = *it;
+            auto last = first;
+
+            for(++it; it != sorted.end() && it->first == to &&
+                      it->second == last + 1U;
+                ++it) {
+                ++last;
+            }
+
+            out << from << ' ';
+            write_byte(out, static_cast<unsigned char>(first));
+            if(last != first) {
+                out << '-';
+                write_byte(out, static_cast<unsigned char>(last));
+            }
+            out << ' ' << to << '\n';
+        }
+    }
+}
+
+} // namespace fsm
@@ -0,0 +1,31 @@
+#ifndef SPEC_HPP
+#define SPEC_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <istream>
+#include <ostream>
+
+namespace fsm {
+
+// Reads an automaton written one statement per line:
+//
+//     start <state>
+//     accept <state>...
+//     <from> <bytes> <to>
+//
+// <bytes> is a character, \xHH, or an inclusive range of those such as a-z or
+// \x00-\x1f. Everything after a '#' is a comment. Throws std::invalid_argument
+// naming the line of the first mistake.
+[[nodiscard]] auto read_spec(std::istream& in) -> builder;
+
+// Writes `build` the way read_spec reads it back: the starting state, the
+// accepting states in order, then the transitions sorted and merged into byte
+// ranges. Builders with the same states, transitions and accepting states are
+// written the same, whatever order they were built in.
+auto write_spec(std::ostream& out, builder const& build) -> void;
+
+} // namespace fsm
+
+#endif // !SPEC_HPP
@@ -0,0 +1,118 @@
+#include "trace.hpp"
+
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace fsm::trace {
+
+static thread_local sink* current_sink{ nullptr };
+
+auto name(phase const what) noexcept -> char const*
+{
+    switch(what) {
+    case phase::lambda_closure:
+        return "lambda_closure";
+    case phase::closed_transitions:
+        return "closed_transitions";
+    case phase::identical_states:
+        return "identical_states";
+    case phase::subset_construction:
+        return "subset_construction";
+    case phase::unreachable_removal:
+        return "unreachable_removal";
+    case phase::equivalence_merging:
+        return "equivalence_merging";
+    }
+
+    return "unknown";
+}
+
+auto set_sink(sink* new_sink) noexcept -> sink*
+{
+    sink* old = current_sink;
+    current_sink = new_sink;
+    return old;
+}
+
+auto get_sink() noexcept -> sink*
+{
+    return current_sink;
+}
+
+scope::scope(phase const what, std::size_t const states_in) noexcept
+    : m_sink{ current_sink }
+{
+    if(m_sink == nullptr) {
+        return;
+    }
+
+    m_event.what = what;
+    m_event.states_in = states_in;
+    m_event.start = clock::now();
+}
+
+scope::~scope() noexcept
+{
+    if(m_sink == nullptr) {
+        return;
+    }
+
+    m_event.duration = clock::now() - m_event.start;
+
+    try {
+        m_sink->on_event(m_event);
+    }
+    catch(...) {
+        // a broken sink must not take the conversion down with it
+    }
+}
+
+auto scope::set_states_out(std::size_t const states_out) noexcept -> void
+{
+    m_event.states_out = states_out;
+}
+
+chrome_sink::chrome_sink(std::ostream& os)
+    : m_os{ &os }
+{
+    (*m_os) << "{\"traceEvents\":[";
+}
+
+chrome_sink::~chrome_sink() noexcept
+{
+    try {
+        (*m_os) << "\n]}\n";
+        m_os->flush();
+    }
+    catch(...) {
+    }
+}
+
+auto chrome_sink::on_event(event const& ev) -> void
+{
+    using micro = std::chrono::duration<double, std::micro>;
+
+    auto const ts = micro{ ev.start.time_since_epoch() }.count();
+    auto const dur = micro{ ev.duration }.count();
+    auto const tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+    std::ostringstream ss{};
+    ss << std::fixed << std::setprecision(3);
+
+    if(!m_first) {
+        ss << ',';
+    }
+    m_first = false;
+
+    ss << "\n{\"name\":\"" << name(ev.what)
+       << "\",\"cat\":\"fsm\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+       << ",\"ts\":" << ts << ",\"dur\":" << dur
+       << ",\"args\":{\"states_in\":" << ev.states_in
+       << ",\"states_out\":" << ev.states_out << "}}";
+
+    (*m_os) << ss.str();
+}
+
+} // namespace fsm::trace
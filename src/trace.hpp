@@ -0,0 +1,102 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+namespace fsm::trace {
+
+using clock = std::chrono::steady_clock;
+
+// Phase boundaries of the lnfa -> nfa -> dfa -> min-dfa pipeline
+enum class phase
+{
+    // lambda closures of the states, when an lnfa is built
+    lambda_closure,
+    // transitions of each state followed by the closures they lead to
+    closed_transitions,
+    identical_states,
+    subset_construction,
+    unreachable_removal,
+    equivalence_merging
+};
+
+[[nodiscard]] auto name(phase const what) noexcept -> char const*;
+
+class event
+{
+public:
+    phase what{ phase::lambda_closure };
+    clock::time_point start{};
+    clock::duration duration{};
+    // number of states going in/out of the phase
+    std::size_t states_in{ 0 };
+    std::size_t states_out{ 0 };
+};
+
+class sink
+{
+public:
+    sink() = default;
+    sink(sink const&) = default;
+    sink(sink&&) noexcept = default;
+    virtual ~sink() noexcept = default;
+
+    auto operator=(sink const&) -> sink& = default;
+    auto operator=(sink&&) noexcept -> sink& = default;
+
+    virtual auto on_event(event const& ev) -> void = 0;
+};
+
+// The sink is per thread, so conversions running on other threads are not
+// reported to it. Returns the previously installed sink.
+auto set_sink(sink* new_sink) noexcept -> sink*;
+[[nodiscard]] auto get_sink() noexcept -> sink*;
+
+// Measures one phase, reports it to the current sink when it goes out of scope
+class scope
+{
+private:
+    sink* m_sink{ nullptr };
+    event m_event{};
+
+public:
+    scope() = delete;
+    scope(scope const&) = delete;
+    scope(scope&&) = delete;
+    ~scope() noexcept;
+
+    scope(phase const what, std::size_t const states_in) noexcept;
+
+    auto operator=(scope const&) -> scope& = delete;
+    auto operator=(scope&&) -> scope& = delete;
+
+    auto set_states_out(std::size_t const states_out) noexcept -> void;
+};
+
+// Writes events in the Chrome trace-event format (chrome://tracing, Perfetto)
+class chrome_sink final : public sink
+{
+private:
+    std::ostream* m_os{ nullptr };
+    bool m_first{ true };
+
+public:
+    chrome_sink() = delete;
+    chrome_sink(chrome_sink const&) = delete;
+    chrome_sink(chrome_sink&&) = delete;
+    ~chrome_sink() noexcept override;
+
+    explicit chrome_sink(std::ostream& os);
+
+    auto operator=(chrome_sink const&) -> chrome_sink& = delete;
+    auto operator=(chrome_sink&&) -> chrome_sink& = delete;
+
+    auto on_event(event const& ev) -> void override;
+};
+
+} // namespace fsm::trace
+
+#endif // !TRACE_HPP
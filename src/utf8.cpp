@@ -0,0 +1,290 @@
+#include "utf8.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+namespace fsm {
+
+namespace {
+
+constexpr std::uint32_t max_code_point = 0x10FFFFU;
+constexpr std::uint32_t surrogate_first = 0xD800U;
+constexpr std::uint32_t surrogate_last = 0xDFFFU;
+
+class byte_span
+{
+public:
+    std::uint32_t low{ 0U };
+    std::uint32_t high{ 0U };
+};
+
+using sequence = std::vector<byte_span>;
+
+// Sorted, merged, without surrogates and nothing past U+10FFFF
+[[nodiscard]] auto normalize(std::vector<code_point_range> const& ranges)
+    -> std::vector<std::pair<std::uint32_t, std::uint32_t>>
+{
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> sorted{};
+
+    for(auto const& range : ranges) {
+        auto const first = static_cast<std::uint32_t>(range.first);
+        auto const last =
+            std::min(static_cast<std::uint32_t>(range.last), max_code_point);
+
+        if(first > last) {
+            continue;
+        }
+        if(first < surrogate_first && last > surrogate_last) {
+            sorted.emplace_back(first, surrogate_first - 1U);
+            sorted.emplace_back(surrogate_last + 1U, last);
+        }
+        else if(first >= surrogate_first && last <= surrogate_last) {
+            continue;
+        }
+        else if(first >= surrogate_first && first <= surrogate_last) {
+            sorted.emplace_back(surrogate_last + 1U, last);
+        }
+        else if(last >= surrogate_first && last <= surrogate_last) {
+            sorted.emplace_back(first, surrogate_first - 1U);
+        }
+        else {
+            sorted.emplace_back(first, last);
+        }
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> result{};
+    for(auto const& range : sorted) {
+        if(!result.empty() && range.first <= result.back().second + 1U) {
+            result.back().second = std::max(result.back().second, range.second);
+        }
+        else {
+            result.push_back(range);
+        }
+    }
+
+    return result;
+}
+
+[[nodiscard]] auto encode(std::uint32_t const cp) -> std::vector<std::uint32_t>
+{
+    constexpr std::uint32_t tail = 0x3FU;
+    constexpr std::uint32_t continuation = 0x80U;
+
+    if(cp < 0x80U) {
+        return { cp };
+    }
+    if(cp < 0x800U) {
+        return { 0xC0U | (cp >> 6U), continuation | (cp & tail) };
+    }
+    if(cp < 0x10000U) {
+        return { 0xE0U | (cp >> 12U),
+                 continuation | ((cp >> 6U) & tail),
+                 continuation | (cp & tail) };
+    }
+
+    return { 0xF0U | (cp >> 18U),
+             continuation | ((cp >> 12U) & tail),
+             continuation | ((cp >> 6U) & tail),
+             continuation | (cp & tail) };
+}
+
+// Splits first..last into ranges whose encodings are the same length and differ
+// in a single byte position, or else cover every continuation byte after it.
+// Each one is then a sequence of byte ranges.
+auto split(std::uint32_t const first,
+           std::uint32_t const last,
+           std::vector<sequence>& out) -> void
+{
+    constexpr std::uint32_t length_limits[] = { 0x7FU, 0x7FFU, 0xFFFFU };
+    constexpr unsigned tail_bits = 6U;
+    constexpr unsigned max_tails = 3U;
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack{
+        { first, last }
+    };
+
+    while(!stack.empty()) {
+        auto const [low, high] = stack.back();
+        stack.pop_back();
+
+        bool divided = false;
+
+        for(std::uint32_t const limit : length_limits) {
+            if(low <= limit && limit < high) {
+                stack.emplace_back(limit + 1U, high);
+                stack.emplace_back(low, limit);
+                divided = true;
+                break;
+            }
+        }
+
+        for(unsigned i = 1U; i <= max_tails && !divided; ++i) {
+            std::uint32_t const mask = (1U << (tail_bits * i)) - 1U;
+
+            if((low & ~mask) == (high & ~mask)) {
+                continue;
+            }
+            if((low & mask) != 0U) {
+                stack.emplace_back((low | mask) + 1U, high);
+                stack.emplace_back(low, low | mask);
+                divided = true;
+            }
+            else if((high & mask) != mask) {
+                stack.emplace_back(high & ~mask, high);
+                stack.emplace_back(low, (high & ~mask) - 1U);
+                divided = true;
+            }
+        }
+
+        if(divided) {
+            continue;
+        }
+
+        auto const from = encode(low);
+        auto const to = encode(high);
+        sequence bytes{};
+
+        for(std::size_t i = 0; i < from.size(); ++i) {
+            bytes.push_back(byte_span{ from[i], to[i] });
+        }
+
+        out.push_back(std::move(bytes));
+    }
+}
+
+// Node of the trie of sequences. Byte ranges going out of a node are equal or
+// disjoint: a range of more than one byte is only ever followed by full
+// continuation ranges, which would overlap any other sequence starting there.
+class node
+{
+public:
+    static constexpr int accept = -1;
+
+    class edge
+    {
+    public:
+        byte_span bytes{};
+        // index of the child node, or accept
+        int to{ accept };
+    };
+
+    std::vector<edge> edges{};
+};
+
+} // namespace
+
+auto add_code_points(builder& build,
+                     int const from,
+                     int const to,
+                     std::vector<code_point_range> const& ranges,
+                     int const first_free) -> int
+{
+    std::vector<sequence> sequences{};
+    for(auto const& [first, last] : normalize(ranges)) {
+        split(first, last, sequences);
+    }
+
+    // shared prefixes
+    std::vector<node> trie(1U);
+
+    for(auto const& bytes : sequences) {
+        std::size_t current{ 0 };
+
+        for(std::size_t i = 0; i < bytes.size(); ++i) {
+            bool const last = i + 1U == bytes.size();
+            auto& edges = trie[current].edges;
+            auto const it =
+                std::find_if(edges.begin(), edges.end(), [&](auto const& e) {
+                    return e.bytes.low == bytes[i].low &&
+                           e.bytes.high == bytes[i].high;
+                });
+
+            if(last) {
+                edges.push_back(node::edge{ bytes[i], node::accept });
+                break;
+            }
+            if(it != edges.end()) {
+                current = static_cast<std::size_t>(it->to);
+                continue;
+            }
+
+            int const child = static_cast<int>(trie.size());
+            edges.push_back(node::edge{ bytes[i], child });
+            trie.emplace_back();
+            current = static_cast<std::size_t>(child);
+        }
+    }
+
+    // shared suffixes: children always come after their parent in the trie,
+    // walking it backwards merges nodes with the same outgoing edges
+    std::map<std::vector<std::uint32_t>, int> signatures{};
+    std::vector<int> state_of(trie.size(), to);
+    int next_free = first_free;
+
+    auto target = [&](int const child) -> int {
+        if(child == node::accept) {
+            return to;
+        }
+        return state_of[static_cast<std::size_t>(child)];
+    };
+
+    for(std::size_t i = trie.size(); i-- > 1U;) {
+        std::vector<std::uint32_t> signature{};
+
+        for(auto const& e : trie[i].edges) {
+            signature.push_back(e.bytes.low);
+            signature.push_back(e.bytes.high);
+            signature.push_back(static_cast<std::uint32_t>(target(e.to)));
+        }
+
+        auto const [it, inserted] =
+            signatures.try_emplace(std::move(signature), next_free);
+
+        if(inserted) {
+            ++next_free;
+
+            for(auto const& e : trie[i].edges) {
+                for(std::uint32_t byte = e.bytes.low; byte <= e.bytes.high;
+                    ++byte) {
+                    build.add_transition(
+                        it->second,
+                        static_cast<char>(static_cast<unsigned char>(byte)),
+                        target(e.to));
+                }
+            }
+        }
+
+        state_of[i] = it->second;
+    }
+
+    for(auto const& e : trie.front().edges) {
+        for(std::uint32_t byte = e.bytes.low; byte <= e.bytes.high; ++byte) {
+            build.add_transition(
+                from,
+                static_cast<char>(static_cast<unsigned char>(byte)),
+                target(e.to));
+        }
+    }
+
+    return next_free;
+}
+
+auto code_points(std::vector<code_point_range> const& ranges) -> builder
+{
+    constexpr int start = 0;
+    constexpr int accepting = 1;
+    builder result{};
+
+    result.set_starting_state(start);
+    result.set_accepting_state(accepting);
+    static_cast<void>(
+        add_code_points(result, start, accepting, ranges, accepting + 1));
+
+    return result;
+}
+
+} // namespace fsm
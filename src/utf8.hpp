@@ -0,0 +1,41 @@
+#ifndef UTF8_HPP
+#define UTF8_HPP
+#pragma once
+
+#include "fsm_builder.hpp"
+
+#include <vector>
+
+namespace fsm {
+
+// Code points first..last, both included
+class code_point_range
+{
+public:
+    char32_t first{ 0 };
+    char32_t last{ 0 };
+};
+
+// Adds the transitions reading exactly one UTF-8 encoded code point of
+// `ranges`, going from state `from` to state `to`. Surrogates and values past
+// U+10FFFF never match, neither do overlong or truncated encodings.
+//
+// The byte sequences are merged into a trie which is then minimized bottom-up,
+// so they share both their prefixes and their suffixes. The result is
+// deterministic as long as `from` has no other transitions on the same bytes.
+// New states are numbered from `first_free`, the first id left unused is
+// returned.
+auto add_code_points(builder& build,
+                     int const from,
+                     int const to,
+                     std::vector<code_point_range> const& ranges,
+                     int const first_free) -> int;
+
+// Automaton accepting one code point of `ranges`: it starts in state 0 and
+// accepts in state 1
+[[nodiscard]] auto code_points(std::vector<code_point_range> const& ranges)
+    -> builder;
+
+} // namespace fsm
+
+#endif // !UTF8_HPP
@@ -0,0 +1,99 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "batch.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Strings over "abc" with an even number of a's, or starting with "cc"
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(0);
+    builder.set_accepting_state(2);
+    builder.set_accepting_state(3);
+    builder.set_accepting_state(4);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 2);
+    builder.add_transition(0, 'c', 3);
+    builder.add_transition(1, 'a', 2);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'c', 1);
+    builder.add_transition(2, 'a', 1);
+    builder.add_transition(2, 'b', 2);
+    builder.add_transition(2, 'c', 2);
+    builder.add_transition(3, 'a', 1);
+    builder.add_transition(3, 'b', 2);
+    builder.add_transition(3, 'c', 4);
+
+    for(int byte = 0; byte < 256; ++byte) {
+        builder.add_transition(4, static_cast<char>(byte), 4);
+    }
+
+    return builder;
+}
+
+// Every lane count gives the verdicts of matching one input at a time
+template<std::size_t Lanes>
+[[nodiscard]] auto lanes_agree(fsm::dfa const& automaton,
+                               std::vector<std::string> const& inputs) -> bool
+{
+    std::vector<std::string_view> const views(inputs.begin(), inputs.end());
+    auto const verdicts = fsm::accepts_batch<Lanes>(automaton, views);
+
+    for(std::size_t i = 0; i < inputs.size(); ++i) {
+        if(verdicts[i] != fsm::accepts(automaton, inputs[i])) {
+            return false;
+        }
+    }
+
+    return verdicts.size() == inputs.size();
+}
+
+} // namespace
+
+TEST("[Batch] agrees with one input at a time")
+{
+    auto const builder = make_builder();
+    fsm::dfa const automaton{ builder };
+    // lanes run out of input at different times
+    auto const inputs = all_strings("abcd", 5U);
+
+    ASSERT(agrees(automaton, fsm::lnfa{ builder }, inputs));
+
+    ASSERT(lanes_agree<1>(automaton, inputs));
+    ASSERT(lanes_agree<4>(automaton, inputs));
+    ASSERT(lanes_agree<fsm::default_lanes>(automaton, inputs));
+    ASSERT(lanes_agree<16>(automaton, inputs));
+
+    // fewer inputs than lanes, and none at all
+    ASSERT(lanes_agree<16>(automaton, { "", "cca", "ab", "d" }));
+    ASSERT(lanes_agree<4>(automaton, {}));
+}
+
+TEST("[Batch] caller buffer")
+{
+    fsm::dfa const automaton{ make_builder() };
+    std::string_view const inputs[] = { "", "a", "aa", "ccd", "ad", "b" };
+    bool verdicts[std::size(inputs)]{};
+
+    fsm::accepts_batch<4>(automaton, inputs, std::size(inputs), verdicts);
+
+    ASSERT(verdicts[0]);
+    ASSERT(!verdicts[1]);
+    ASSERT(verdicts[2]);
+    ASSERT(verdicts[3]);
+    ASSERT(!verdicts[4]);
+    ASSERT(verdicts[5]);
+}
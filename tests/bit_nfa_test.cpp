@@ -0,0 +1,105 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "bit_nfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "test.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST("[Bit NFA] agrees with the lambda-NFA")
+{
+    auto builder = make_small_lnfa();
+    // can't reach an accepting state, it isn't given a bit
+    builder.add_transition(3, 'd', 4);
+
+    fsm::bit_nfa const bits{ builder };
+    fsm::lnfa const reference{ builder };
+
+    ASSERT(bits.state_count() == 4U);
+    ASSERT(agrees(bits, reference, all_strings("abcd", 6U)));
+
+    auto const blowup = make_blowup(10);
+    fsm::bit_nfa const chain{ blowup };
+    ASSERT(chain.state_count() == 12U);
+    ASSERT(agrees(chain, fsm::lnfa{ blowup }, all_strings("abc", 12U)));
+}
+
+TEST("[Bit NFA] several words of states")
+{
+    // 102 states, transitions cross from one word to the next
+    auto const blowup = make_blowup(100);
+    fsm::lnfa const reference{ blowup };
+
+    fsm::basic_bit_nfa<2> const two_words{ blowup };
+    ASSERT(two_words.state_count() == 102U);
+
+    std::vector<std::string> inputs{};
+    std::string input(100U, 'b');
+    for(std::size_t i = 0; i < 110U; ++i) {
+        inputs.push_back(input);
+        input[i % input.size()] = 'a';
+        input.push_back(i % 3U == 0U ? 'a' : 'b');
+    }
+    ASSERT(agrees(two_words, reference, inputs));
+
+    bool threw{ false };
+    try {
+        fsm::bit_nfa const too_big{ blowup };
+        static_cast<void>(too_big);
+    }
+    catch(std::invalid_argument const&) {
+        threw = true;
+    }
+    ASSERT(threw);
+}
+
+TEST("[Bit NFA] stops once the outcome is decided")
+{
+    fsm::builder builder{};
+
+    // a(anything)*
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+
+    fsm::bit_nfa const bits{ builder };
+    auto state = bits.initial();
+
+    ASSERT(!bits.is_accepting(state));
+    // the byte 0 is never matched
+    bool const stuck = !bits.step(state, '\0');
+    ASSERT(stuck);
+    ASSERT(!bits.is_accepting(state));
+
+    state = bits.initial();
+    ASSERT(bits.step(state, 'a'));
+    ASSERT(bits.is_accepting(state));
+    ASSERT(fsm::accepts(bits, "abba"));
+    ASSERT(!fsm::accepts(bits, "ba"));
+}
+
+TEST("[Bit NFA] lambda edges do not accept the byte 0")
+{
+    // a catch-all over every byte but 0, linked to itself by a lambda edge
+    fsm::builder builder{};
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, fsm::lambda, 1);
+    for(int byte = 1; byte < 256; ++byte) {
+        builder.add_transition(1, static_cast<char>(byte), 1);
+    }
+
+    fsm::bit_nfa const bits{ builder };
+
+    using namespace std::string_literals;
+    for(auto const& input : { "a"s, "abc"s, "a\0"s, "ab\0c"s }) {
+        ASSERT(fsm::accepts(bits, input) == (input.find('\0') == input.npos));
+    }
+}
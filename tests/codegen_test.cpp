@@ -0,0 +1,111 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "codegen.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "spec.hpp"
+#include "test.hpp"
+
+#include "identifier.hpp"
+#include "request_line.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto load(std::string const& name) -> fsm::dfa
+{
+    std::ifstream spec{ std::string{ SPEC_DIR } + "/" + name + ".lfa" };
+    return fsm::dfa{ fsm::dfa{ fsm::read_spec(spec) }.minimize() };
+}
+
+template<typename Matcher>
+[[nodiscard]] auto agrees(Matcher&& matcher,
+                          fsm::dfa const& reference,
+                          std::vector<std::string> const& inputs) -> bool
+{
+    for(auto const& input : inputs) {
+        if(matcher(input) != fsm::accepts(reference, input)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard]] auto rejects(std::string const& text) -> bool
+{
+    std::istringstream in{ text };
+
+    try {
+        static_cast<void>(fsm::read_spec(in));
+    }
+    catch(std::invalid_argument const&) {
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace
+
+TEST("[Codegen] spec")
+{
+    std::istringstream in{ "start 1 # comment\n"
+                           "accept 2 3\n"
+                           "1 a-c 2\n"
+                           "2 \\x41 3\n"
+                           "3 - 3\n" };
+    fsm::dfa const dfa{ fsm::read_spec(in) };
+
+    ASSERT(fsm::accepts(dfa, "b"));
+    ASSERT(fsm::accepts(dfa, "cA--"));
+    ASSERT(!fsm::accepts(dfa, "d"));
+    ASSERT(!fsm::accepts(dfa, ""));
+
+    ASSERT(rejects("start x\n"));
+    ASSERT(rejects("0 a\n"));
+    ASSERT(rejects("0 z-a 1\n"));
+    ASSERT(rejects("0 \\xZZ 1\n"));
+    ASSERT(rejects("accept 1 -2\n"));
+    ASSERT(rejects("0 a 1 2\n"));
+}
+
+TEST("[Codegen] generated matchers agree with the DFA")
+{
+    auto const identifier = load("identifier");
+    auto const request_line = load("request_line");
+
+    ASSERT(agrees(fsm::generated::identifier,
+                  identifier,
+                  all_strings("aZ_0-", 5U)));
+    ASSERT(agrees(fsm::generated::request_line,
+                  request_line,
+                  all_strings("GET \xff", 6U)));
+
+    std::string const with_zero{ "GET \0\xff", 6U };
+    ASSERT(fsm::generated::request_line(with_zero));
+    ASSERT(!fsm::generated::identifier(with_zero));
+}
+
+TEST("[Codegen] source")
+{
+    std::ostringstream header{};
+    std::ostringstream source{};
+
+    fsm::write_matcher_header("request_line", header);
+    fsm::write_matcher_source(load("request_line"), "request_line", source);
+
+    bool const declared = header.str().find(
+        "auto request_line(std::string_view input)") != std::string::npos;
+    // the state accepting everything returns right away
+    bool const early_return =
+        source.str().find(":\n    return true;") != std::string::npos;
+
+    ASSERT(declared);
+    ASSERT(early_return);
+}
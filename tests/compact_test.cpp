@@ -0,0 +1,105 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "compact.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Counts the 'a's modulo n, accepting when it is 0; 'b' goes back to the start
+// and 'c' only from the last state, to one looping on 'a'
+[[nodiscard]] auto make_counter(int const n) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(0);
+    builder.set_accepting_state(n);
+    builder.add_transition(n, 'a', n);
+
+    for(int state = 0; state < n; ++state) {
+        builder.add_transition(state, 'a', (state + 1) % n);
+        builder.add_transition(state, 'b', 0);
+    }
+    builder.add_transition(n - 1, 'c', n);
+
+    return builder;
+}
+
+// Bytes of the state ids visit_compact picks for `automaton`
+[[nodiscard]] auto id_bytes(fsm::dfa const& automaton) -> std::size_t
+{
+    return fsm::visit_compact(automaton, [](auto const& compact) {
+        return sizeof(typename std::decay_t<decltype(compact)>::run_state);
+    });
+}
+
+} // namespace
+
+TEST("[Compact] keeps the language")
+{
+    fsm::dfa const reference{ make_counter(4) };
+    fsm::compact_dfa<std::uint8_t> const narrow{ reference };
+    fsm::compact_dfa<std::uint32_t> const wide{ reference };
+    auto const inputs = all_strings("abcd", 7U);
+
+    ASSERT(narrow.state_count() == reference.table().state_count());
+    ASSERT(agrees(narrow, reference, inputs));
+    ASSERT(agrees(wide, reference, inputs));
+
+    bool const smaller = narrow.memory_footprint() < wide.memory_footprint();
+    ASSERT(smaller);
+
+    bool const visited = fsm::visit_compact(reference, [&](auto const& any) {
+        return agrees(any, reference, inputs);
+    });
+    ASSERT(visited);
+}
+
+TEST("[Compact] picks the narrowest ids")
+{
+    fsm::dfa const small{ make_counter(200) };
+    fsm::dfa const medium{ make_counter(1000) };
+    fsm::dfa const large{ make_counter(70000) };
+
+    ASSERT(id_bytes(small) == 1U);
+    ASSERT(id_bytes(medium) == 2U);
+    ASSERT(id_bytes(large) == 4U);
+
+    std::string input(69999U, 'a');
+    input += "caa";
+    bool const accepted = fsm::visit_compact(large, [&](auto const& any) {
+        return fsm::accepts(any, input);
+    });
+    ASSERT(accepted);
+    ASSERT(fsm::accepts(large, input) == accepted);
+}
+
+TEST("[Compact] refuses tables too large for the ids")
+{
+    // 254 counting states and the accept-all one: the last id is dead
+    fsm::dfa const fits{ make_counter(254) };
+    fsm::dfa const too_large{ make_counter(255) };
+    bool thrown{ false };
+
+    fsm::compact_dfa<std::uint8_t> const narrow{ fits };
+    ASSERT(narrow.state_count() == 255U);
+
+    try {
+        fsm::compact_dfa<std::uint8_t> const overflow{ too_large };
+        static_cast<void>(overflow);
+    }
+    catch(std::invalid_argument const&) {
+        thrown = true;
+    }
+
+    ASSERT(thrown);
+}
@@ -0,0 +1,205 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "compile_cache.hpp"
+#include "dfa.hpp"
+#include "equivalence.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "spec.hpp"
+#include "test.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace {
+
+// (a|b)*a(a|b){n} with a lambda transition in front of it
+[[nodiscard]] auto make_lambda_blowup(int const n) -> fsm::builder
+{
+    auto builder = make_blowup(n);
+
+    builder.set_starting_state(n + 2);
+    builder.add_transition(n + 2, fsm::lambda, 0);
+
+    return builder;
+}
+
+[[nodiscard]] auto spec_of(fsm::builder const& build) -> std::string
+{
+    std::ostringstream out{};
+    fsm::write_spec(out, build);
+
+    return out.str();
+}
+
+// Where a cache in `directory` keeps the entry of `build`
+[[nodiscard]] auto entry_of(std::filesystem::path const& directory,
+                            fsm::builder const& build) -> std::filesystem::path
+{
+    std::ostringstream name{};
+    name << std::hex << std::setw(16) << std::setfill('0')
+         << fsm::content_hash(build) << ".lfa";
+
+    return directory / name.str();
+}
+
+// Empty directory of its own for a test
+[[nodiscard]] auto fresh_directory(std::string const& name)
+    -> std::filesystem::path
+{
+    auto const path =
+        std::filesystem::temp_directory_path() / ("lfa_" + name);
+
+    std::filesystem::remove_all(path);
+    return path;
+}
+
+} // namespace
+
+TEST("[Compile cache] specs are written the same whatever the order")
+{
+    fsm::builder forward{};
+    forward.set_starting_state(0);
+    forward.set_accepting_state(2);
+    forward.set_accepting_state(1);
+    for(char ch = 'a'; ch <= 'z'; ++ch) {
+        forward.add_transition(0, ch, 1);
+    }
+    forward.add_transition(1, '-', 2);
+    forward.add_transition(1, fsm::lambda, 2);
+
+    fsm::builder backward{};
+    backward.set_starting_state(0);
+    backward.set_accepting_state(1);
+    backward.set_accepting_state(2);
+    backward.add_transition(1, fsm::lambda, 2);
+    backward.add_transition(1, '-', 2);
+    for(char ch = 'z'; ch >= 'a'; --ch) {
+        backward.add_transition(0, ch, 1);
+    }
+
+    auto const text = spec_of(forward);
+    ASSERT(text == spec_of(backward));
+    ASSERT(text == "start 0\naccept 1 2\n0 a-z 1\n1 \\x00 2\n1 \\x2d 2\n");
+    ASSERT(fsm::content_hash(forward) == fsm::content_hash(backward));
+
+    std::istringstream in{ text };
+    auto const read_back = fsm::read_spec(in);
+    ASSERT(spec_of(read_back) == text);
+    ASSERT(fsm::equivalent(read_back, forward).equal);
+
+    backward.set_accepting_state(0);
+    ASSERT(fsm::content_hash(forward) != fsm::content_hash(backward));
+}
+
+TEST("[Compile cache] repeated builds come from the cache")
+{
+    auto const directory = fresh_directory("compile_cache_hits");
+    auto const build = make_lambda_blowup(6);
+    auto const expected = fsm::compile_minimized(build);
+
+    fsm::compile_cache cache{ directory };
+    auto const first = cache.minimized(build);
+    auto const second = cache.minimized(build);
+
+    ASSERT(cache.misses() == 1U);
+    ASSERT(cache.hits() == 1U);
+    ASSERT(spec_of(first) == spec_of(expected));
+    ASSERT(spec_of(second) == spec_of(expected));
+    ASSERT(fsm::equivalent(fsm::dfa{ second }, fsm::dfa{ expected }).equal);
+
+    // another process, the same directory
+    fsm::compile_cache other{ directory };
+    ASSERT(spec_of(other.minimized(build)) == spec_of(expected));
+    ASSERT(other.hits() == 1U);
+    ASSERT(other.misses() == 0U);
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST("[Compile cache] broken entries are compiled again")
+{
+    auto const directory = fresh_directory("compile_cache_broken");
+    auto const build = make_lambda_blowup(3);
+    fsm::compile_cache cache{ directory };
+
+    static_cast<void>(cache.minimized(build));
+
+    for(auto const& entry : std::filesystem::directory_iterator{ directory }) {
+        std::ofstream out{ entry.path(), std::ios::trunc };
+        out << "start 0\n";
+    }
+    ASSERT(!cache.find(build).has_value());
+
+    for(auto const& entry : std::filesystem::directory_iterator{ directory }) {
+        std::ofstream out{ entry.path(), std::ios::app };
+        out << "#minimized\n0 a 1 2 3\n";
+    }
+    ASSERT(!cache.find(build).has_value());
+
+    auto const minimized = cache.minimized(build);
+    ASSERT(spec_of(minimized) == spec_of(fsm::compile_minimized(build)));
+    ASSERT(cache.find(build).has_value());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST("[Compile cache] entries stay within the bound")
+{
+    auto const directory = fresh_directory("compile_cache_bound");
+    constexpr std::uintmax_t max_bytes = 4096U;
+    fsm::compile_cache cache{ directory, max_bytes };
+
+    // file times may be coarser than the time between two entries, each one
+    // is dated an hour after the one before
+    auto const start = std::filesystem::file_time_type::clock::now() -
+                       std::chrono::hours{ 24 };
+
+    for(int n = 1; n <= 6; ++n) {
+        auto const build = make_lambda_blowup(n);
+        static_cast<void>(cache.minimized(build));
+
+        bool const bounded = cache.size() <= max_bytes;
+        ASSERT(bounded);
+
+        std::error_code gone{};
+        std::filesystem::last_write_time(
+            entry_of(directory, build), start + std::chrono::hours{ n }, gone);
+    }
+
+    // the last one is the most recently used, it stays
+    ASSERT(cache.find(make_lambda_blowup(6)).has_value());
+    ASSERT(!cache.find(make_lambda_blowup(1)).has_value());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST("[Compile cache] temporaries of dead writers are removed")
+{
+    auto const directory = fresh_directory("compile_cache_scratch");
+    fsm::compile_cache cache{ directory };
+    auto const now = std::filesystem::file_time_type::clock::now();
+
+    auto const stale = directory / "0000000000000000.lfa.1.2.tmp";
+    auto const fresh = directory / "0000000000000000.lfa.3.4.tmp";
+    for(auto const& path : { stale, fresh }) {
+        std::ofstream out{ path, std::ios::binary };
+        out << "half an entry";
+    }
+    std::filesystem::last_write_time(stale, now - std::chrono::hours{ 1 });
+
+    // the temporaries take room as well
+    ASSERT(cache.size() == 26U);
+
+    static_cast<void>(cache.minimized(make_lambda_blowup(2)));
+    ASSERT(!std::filesystem::exists(stale));
+    // it may belong to a writer still at it
+    ASSERT(std::filesystem::exists(fresh));
+
+    std::filesystem::remove_all(directory);
+}
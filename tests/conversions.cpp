@@ -1,5 +1,7 @@
 #define MAIN_EXECUTABLE
+#include "automata.hpp"
 #include "dfa.hpp"
+#include "equivalence.hpp"
 #include "fsm_builder.hpp"
 #include "lnfa.hpp"
 #include "nfa.hpp"
@@ -23,35 +25,29 @@ template<typename T, typename U>
     return a == b;
 }
 
-TEST("[LNFA -> NFA -> DFA -> Min-DFA]")
+// The polymorphic path and the static dispatch path must agree
+template<typename Engine>
+[[nodiscard]] auto same_verdicts(Engine& engine,
+                                 std::vector<std::string> const& inputs)
+    -> bool
 {
-    using fsm::lambda;
-    fsm::builder builder{};
-
-    builder.set_starting_state(0);
-    builder.set_accepting_state(2);
-    builder.set_accepting_state(6);
+    for(auto const& input : inputs) {
+        engine.reset();
+        bool const dynamic =
+            fsm::accepts(static_cast<fsm::automaton&>(engine), input);
+
+        if(dynamic != fsm::accepts(engine, input)) {
+            return false;
+        }
+    }
+
+    engine.reset();
+    return true;
+}
 
-    builder.add_transition(0, 'a', 0);
-    builder.add_transition(0, 'a', 1);
-    builder.add_transition(0, 'b', 2);
-    builder.add_transition(0, lambda, 2);
-    builder.add_transition(0, lambda, 3);
-    builder.add_transition(1, lambda, 2);
-    builder.add_transition(2, 'a', 3);
-    builder.add_transition(2, lambda, 4);
-    builder.add_transition(3, 'b', 3);
-    builder.add_transition(3, lambda, 5);
-    builder.add_transition(3, 'a', 6);
-    builder.add_transition(3, 'b', 6);
-    builder.add_transition(4, 'b', 5);
-    builder.add_transition(4, 'a', 6);
-    builder.add_transition(4, lambda, 6);
-    builder.add_transition(5, lambda, 2);
-    builder.add_transition(5, 'b', 2);
-    builder.add_transition(5, lambda, 6);
-    builder.add_transition(5, 'a', 6);
-    builder.add_transition(6, 'b', 6);
+TEST("[LNFA -> NFA -> DFA -> Min-DFA]")
+{
+    auto const builder = make_lambda_heavy();
 
     ASSERT(builder.get_alphabet() == "ab");
 
@@ -68,8 +64,10 @@ TEST("[LNFA -> NFA -> DFA -> Min-DFA]")
     std::cout << "LNFA:\n";
     lnfa.print_transitions();
 
-    fsm::nfa nfa{ lnfa.to_nfa() };
+    auto const nfa_builder = lnfa.to_nfa();
+    fsm::nfa nfa{ nfa_builder };
 
+    ASSERT(fsm::equivalent(builder, nfa_builder).equal);
     ASSERT_ACCEPT(nfa, "");
     ASSERT_ACCEPT(nfa, "a");
     ASSERT_ACCEPT(nfa, "b");
@@ -81,8 +79,10 @@ TEST("[LNFA -> NFA -> DFA -> Min-DFA]")
     std::cout << "\nNFA:\n";
     nfa.print_transitions();
 
-    fsm::dfa dfa{ nfa.to_dfa() };
+    auto const dfa_builder = nfa.to_dfa();
+    fsm::dfa dfa{ dfa_builder };
 
+    ASSERT(fsm::equivalent(nfa_builder, dfa_builder).equal);
     ASSERT_ACCEPT(dfa, "");
     ASSERT_ACCEPT(dfa, "a");
     ASSERT_ACCEPT(dfa, "b");
@@ -96,6 +96,7 @@ TEST("[LNFA -> NFA -> DFA -> Min-DFA]")
 
     fsm::dfa min_dfa{ dfa.minimize() };
 
+    ASSERT(fsm::equivalent(dfa, min_dfa).equal);
     ASSERT_ACCEPT(min_dfa, "");
     ASSERT_ACCEPT(min_dfa, "a");
     ASSERT_ACCEPT(min_dfa, "b");
@@ -131,8 +132,10 @@ TEST("[NFA -> DFA -> Min-DFA]")
     ASSERT_ACCEPT(nfa, "aaaabbbbb");
     ASSERT_NOT_ACCEPT(nfa, "aaaabbbbba");
 
-    fsm::dfa dfa{ nfa.to_dfa() };
+    auto const dfa_builder = nfa.to_dfa();
+    fsm::dfa dfa{ dfa_builder };
 
+    ASSERT(fsm::equivalent(builder, dfa_builder).equal);
     ASSERT_NOT_ACCEPT(dfa, "");
     ASSERT_NOT_ACCEPT(dfa, "b");
     ASSERT_ACCEPT(dfa, "ab");
@@ -141,6 +144,7 @@ TEST("[NFA -> DFA -> Min-DFA]")
 
     fsm::dfa min_dfa{ dfa.minimize() };
 
+    ASSERT(fsm::equivalent(dfa, min_dfa).equal);
     ASSERT_NOT_ACCEPT(min_dfa, "");
     ASSERT_NOT_ACCEPT(min_dfa, "b");
     ASSERT_ACCEPT(min_dfa, "ab");
@@ -181,6 +185,7 @@ TEST("[DFA -> Min-DFA]")
 
     fsm::dfa min_dfa{ dfa.minimize() };
 
+    ASSERT(fsm::equivalent(dfa, min_dfa).equal);
     ASSERT_NOT_ACCEPT(min_dfa, "");
     ASSERT_ACCEPT(min_dfa, "ab");
     ASSERT_NOT_ACCEPT(min_dfa, "bb");
@@ -188,3 +193,20 @@ TEST("[DFA -> Min-DFA]")
     ASSERT_ACCEPT(min_dfa, "abaaa");
     ASSERT_NOT_ACCEPT(min_dfa, "abaaab");
 }
+
+TEST("[Static dispatch]")
+{
+    auto const builder = make_small_lnfa();
+
+    auto const inputs = all_strings("abc", 6);
+
+    fsm::lnfa lnfa{ builder };
+    fsm::nfa nfa{ lnfa.to_nfa() };
+    fsm::dfa dfa{ nfa.to_dfa() };
+    fsm::dfa min_dfa{ dfa.minimize() };
+
+    ASSERT(same_verdicts(lnfa, inputs));
+    ASSERT(same_verdicts(nfa, inputs));
+    ASSERT(same_verdicts(dfa, inputs));
+    ASSERT(same_verdicts(min_dfa, inputs));
+}
@@ -0,0 +1,93 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "cursor.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST("[Cursor] independent cursors over one automaton")
+{
+    auto const shared = fsm::share(fsm::dfa{ make_a_ab_star_b() });
+
+    fsm::cursor<fsm::dfa> first{ shared };
+    fsm::cursor<fsm::dfa> second{ shared };
+
+    first.feed("aab");
+    second.feed("ab");
+    second.next('a');
+
+    ASSERT(first.accepted());
+    ASSERT(!second.accepted());
+    ASSERT(!second.aborted());
+
+    second.next('c');
+    ASSERT(second.aborted());
+
+    second.reset();
+    second.feed("abbb");
+    ASSERT(second.accepted());
+
+    // only the run state is per cursor
+    bool const small = sizeof(first) <= 2U * sizeof(shared) + sizeof(int) * 2U;
+    ASSERT(small);
+    ASSERT(shared.use_count() == 3);
+
+    fsm::cursor<fsm::nfa> nfa{ fsm::share(fsm::nfa{ make_a_ab_star_b() }) };
+    fsm::cursor<fsm::lnfa> lnfa{ fsm::share(fsm::lnfa{ make_a_ab_star_b() }) };
+
+    nfa.feed("abab");
+    lnfa.feed("aba");
+    ASSERT(nfa.accepted());
+    ASSERT(!lnfa.accepted());
+}
+
+TEST("[Cursor] one cursor per thread")
+{
+    constexpr std::size_t thread_count = 8U;
+    constexpr std::size_t rounds = 1000U;
+
+    auto const shared = fsm::share(fsm::dfa{ make_a_ab_star_b() });
+    std::vector<std::size_t> accepted(thread_count, 0U);
+    std::vector<std::thread> threads{};
+
+    for(std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&shared, &accepted, t] {
+            fsm::cursor<fsm::dfa> cursor{ shared };
+
+            for(std::size_t i = 0; i < rounds; ++i) {
+                cursor.reset();
+                cursor.feed(i % 2U == 0U ? "aabab" : "aaba");
+                accepted[t] += cursor.accepted() ? 1U : 0U;
+            }
+        });
+    }
+
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    for(std::size_t const count : accepted) {
+        ASSERT(count == rounds / 2U);
+    }
+}
+
+TEST("[Cursor] copies of an automaton share what they compiled")
+{
+    fsm::dfa original{ make_a_ab_star_b() };
+    original.next('a');
+
+    fsm::dfa copy{ original };
+    copy.reset();
+    copy.next('b');
+
+    ASSERT(copy.aborted());
+    ASSERT(!original.aborted());
+    ASSERT(&copy.table() == &original.table());
+}
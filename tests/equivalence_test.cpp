@@ -0,0 +1,133 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "dfa.hpp"
+#include "equivalence.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "test.hpp"
+
+#include <string>
+
+namespace {
+
+// Strings over "ab" whose length is a multiple of `period`
+[[nodiscard]] auto make_cycle(int const period) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(0);
+
+    for(int state = 0; state < period; ++state) {
+        builder.add_transition(state, 'a', (state + 1) % period);
+        builder.add_transition(state, 'b', (state + 1) % period);
+    }
+
+    return builder;
+}
+
+// Strings over "ab" of any length but `missing`
+[[nodiscard]] auto make_all_but(int const missing) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+
+    for(int state = 0; state <= missing; ++state) {
+        if(state != missing) {
+            builder.set_accepting_state(state);
+        }
+        builder.add_transition(state, 'a', state + 1);
+        builder.add_transition(state, 'b', state + 1);
+    }
+
+    builder.set_accepting_state(missing + 1);
+    builder.add_transition(missing + 1, 'a', missing + 1);
+    builder.add_transition(missing + 1, 'b', missing + 1);
+
+    return builder;
+}
+
+} // namespace
+
+TEST("[Equivalence] DFAs")
+{
+    fsm::dfa const even{ make_cycle(2) };
+    fsm::dfa const by_four{ make_cycle(4) };
+
+    // twice as many states for the same language
+    auto twice = make_cycle(4);
+    twice.set_accepting_state(2);
+    fsm::dfa const even_again{ twice };
+
+    ASSERT(fsm::equivalent(even, even).equal);
+
+    auto const same_period = fsm::equivalent(even, even_again);
+    ASSERT(same_period.equal);
+    ASSERT(same_period.counterexample.empty());
+
+    // "aa" is the shortest string of even length not of a length divisible
+    // by 4
+    auto const different = fsm::equivalent(even, by_four);
+    ASSERT(!different.equal);
+    ASSERT(different.counterexample == "aa");
+
+    // different bytes: "b" is the shortest one
+    fsm::builder only_a{};
+    only_a.set_starting_state(0);
+    only_a.set_accepting_state(0);
+    only_a.add_transition(0, 'a', 0);
+    only_a.add_transition(0, 'b', 1);
+
+    fsm::builder only_b = only_a;
+    only_b.set_accepting_state(1);
+
+    auto const bytes = fsm::equivalent(fsm::dfa{ only_a }, fsm::dfa{ only_b });
+    ASSERT(!bytes.equal);
+    ASSERT(bytes.counterexample == "b");
+}
+
+TEST("[Equivalence] NFAs")
+{
+    using fsm::lambda;
+
+    ASSERT(fsm::equivalent(make_blowup(6), make_blowup(6)).equal);
+
+    auto const shifted = fsm::equivalent(make_blowup(6), make_blowup(5));
+    ASSERT(!shifted.equal);
+    ASSERT(shifted.counterexample.size() == 6U);
+
+    // the same language written with lambda transitions
+    fsm::builder with_lambda{};
+    with_lambda.set_starting_state(0);
+    with_lambda.set_accepting_state(4);
+    with_lambda.add_transition(0, 'a', 0);
+    with_lambda.add_transition(0, 'b', 0);
+    with_lambda.add_transition(0, 'a', 1);
+    with_lambda.add_transition(1, lambda, 2);
+    with_lambda.add_transition(2, 'a', 3);
+    with_lambda.add_transition(2, 'b', 3);
+    with_lambda.add_transition(3, lambda, 4);
+
+    ASSERT(fsm::equivalent(with_lambda, make_blowup(1)).equal);
+
+    // a counterexample that only one of the two accepts, and no shorter one
+    auto const missing = fsm::equivalent(make_all_but(6), make_cycle(1));
+    ASSERT(!missing.equal);
+    ASSERT(missing.counterexample.size() == 6U);
+}
+
+TEST("[Equivalence] conversions")
+{
+    auto const builder = make_small_lnfa();
+
+    fsm::lnfa lnfa{ builder };
+    auto const nfa = lnfa.to_nfa();
+
+    ASSERT(fsm::equivalent(builder, nfa).equal);
+
+    fsm::dfa const dfa{ make_cycle(6) };
+    fsm::dfa const minimized{ dfa.minimize() };
+
+    ASSERT(fsm::equivalent(dfa, minimized).equal);
+}
@@ -1,8 +1,12 @@
 #define MAIN_EXECUTABLE
+#include "automata.hpp"
 #include "fsm_builder.hpp"
 #include "lnfa.hpp"
 #include "test.hpp"
 
+#include <string>
+#include <vector>
+
 using vec = std::vector<int>;
 
 template<typename T, typename U>
@@ -54,3 +58,55 @@ TEST("[FSM Builder]")
     ASSERT(config.at(7).size() == 3);
     ASSERT(config.at(8).size() == 2);
 }
+
+TEST("[FSM Builder] reverse")
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    // a(b|c)*x with a lambda transition, or just "yy"; accepting twice
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+    builder.set_accepting_state(5);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'c', 1);
+    builder.add_transition(1, lambda, 2);
+    builder.add_transition(2, 'x', 3);
+    builder.add_transition(0, 'y', 4);
+    builder.add_transition(4, 'y', 5);
+
+    auto const reversed = builder.reverse();
+    fsm::lnfa const forward{ builder };
+    fsm::lnfa const backward{ reversed };
+
+    ASSERT(reversed.get_alphabet() == builder.get_alphabet());
+    ASSERT(reversed.get_starting_state() == 6);
+    ASSERT(eq(reversed.get_accepting_states(), vec({ 0 })));
+
+    auto const inputs = all_strings("abcxy", 6U);
+    bool mirrors{ true };
+
+    for(auto const& input : inputs) {
+        std::string const mirrored(input.rbegin(), input.rend());
+
+        mirrors = mirrors && fsm::accepts(forward, input) ==
+                                 fsm::accepts(backward, mirrored);
+    }
+    ASSERT(mirrors);
+
+    // reversed twice, it is the same language again
+    ASSERT(agrees(fsm::lnfa{ reversed.reverse() }, forward, inputs));
+
+    // one accepting state: it is the start, nothing is added
+    fsm::builder single{};
+    single.set_starting_state(0);
+    single.set_accepting_state(2);
+    single.add_transition(0, 'a', 1);
+    single.add_transition(1, 'b', 2);
+
+    auto const ba = single.reverse();
+    ASSERT(ba.get_starting_state() == 2);
+    ASSERT(ba.get_configuration().size() == 2U);
+    ASSERT(ba.get_configuration().at(2).front().on == 'b');
+}
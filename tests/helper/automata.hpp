@@ -0,0 +1,140 @@
+#ifndef AUTOMATA_HPP
+#define AUTOMATA_HPP
+#pragma once
+
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Every string over `alphabet` of length at most `max_length`
+[[nodiscard]] inline auto all_strings(std::string const& alphabet,
+                                      std::size_t const max_length)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> result{ "" };
+
+    for(std::size_t i = 0; i < result.size(); ++i) {
+        if(result[i].size() == max_length) {
+            continue;
+        }
+        for(char const ch : alphabet) {
+            result.push_back(result[i] + ch);
+        }
+    }
+
+    return result;
+}
+
+// (a|b)*a(a|b){n}: the NFA has n + 2 states, the DFA 2^(n + 1)
+[[nodiscard]] inline auto make_blowup(int const n) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(n + 1);
+
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'b', 0);
+    builder.add_transition(0, 'a', 1);
+
+    for(int state = 1; state <= n; ++state) {
+        builder.add_transition(state, 'a', state + 1);
+        builder.add_transition(state, 'b', state + 1);
+    }
+
+    return builder;
+}
+
+// a(a|b)*b
+[[nodiscard]] inline auto make_a_ab_star_b() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'a', 1);
+    builder.add_transition(1, 'b', 2);
+    builder.add_transition(2, 'a', 1);
+    builder.add_transition(2, 'b', 2);
+
+    return builder;
+}
+
+// Four states over "abc", two lambda transitions, one of them backwards
+[[nodiscard]] inline auto make_small_lnfa() -> fsm::builder
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'b', 1);
+    builder.add_transition(0, lambda, 2);
+    builder.add_transition(1, 'a', 2);
+    builder.add_transition(1, 'a', 3);
+    builder.add_transition(2, 'b', 3);
+    builder.add_transition(2, lambda, 1);
+    builder.add_transition(3, 'a', 0);
+    builder.add_transition(3, 'c', 3);
+
+    return builder;
+}
+
+// Lambda transitions all over, chains and cycles of them included
+[[nodiscard]] inline auto make_lambda_heavy() -> fsm::builder
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+    builder.set_accepting_state(6);
+
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 2);
+    builder.add_transition(0, lambda, 2);
+    builder.add_transition(0, lambda, 3);
+    builder.add_transition(1, lambda, 2);
+    builder.add_transition(2, 'a', 3);
+    builder.add_transition(2, lambda, 4);
+    builder.add_transition(3, 'b', 3);
+    builder.add_transition(3, lambda, 5);
+    builder.add_transition(3, 'a', 6);
+    builder.add_transition(3, 'b', 6);
+    builder.add_transition(4, 'b', 5);
+    builder.add_transition(4, 'a', 6);
+    builder.add_transition(4, lambda, 6);
+    builder.add_transition(5, lambda, 2);
+    builder.add_transition(5, 'b', 2);
+    builder.add_transition(5, lambda, 6);
+    builder.add_transition(5, 'a', 6);
+    builder.add_transition(6, 'b', 6);
+
+    return builder;
+}
+
+// Whether `engine` and `reference` give the same verdict on every input
+template<typename Engine, typename Reference>
+[[nodiscard]] auto agrees(Engine const& engine,
+                          Reference const& reference,
+                          std::vector<std::string> const& inputs) -> bool
+{
+    for(auto const& input : inputs) {
+        if(fsm::accepts(engine, input) != fsm::accepts(reference, input)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif // !AUTOMATA_HPP
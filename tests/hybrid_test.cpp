@@ -0,0 +1,123 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "hybrid.hpp"
+#include "lnfa.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <vector>
+
+template<typename T, typename U>
+[[nodiscard]] auto eq(T const& a, U const& b) noexcept -> bool
+{
+    return a == b;
+}
+
+TEST("[Hybrid] fits in the budget")
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    // (ab)*|c with lambda transitions
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+    builder.add_transition(0, lambda, 1);
+    builder.add_transition(0, 'c', 3);
+    builder.add_transition(1, 'a', 2);
+    builder.add_transition(2, 'b', 1);
+    builder.add_transition(1, lambda, 3);
+
+    fsm::hybrid const hybrid{ builder };
+    fsm::lnfa const reference{ builder };
+
+    ASSERT(eq(hybrid.chosen(), fsm::hybrid::engine::dfa));
+    ASSERT(std::string{ fsm::name(hybrid.chosen()) } == "dfa");
+    ASSERT(agrees(hybrid, reference, all_strings("abcd", 6U)));
+
+    fsm::hybrid const blowup{ make_blowup(4) };
+    ASSERT(eq(blowup.chosen(), fsm::hybrid::engine::dfa));
+    ASSERT(blowup.state_count() == 32U);
+}
+
+TEST("[Hybrid] falls back to the lazy DFA")
+{
+    auto const builder = make_blowup(10);
+    fsm::lnfa const reference{ builder };
+
+    fsm::budget few_states{};
+    few_states.max_states = 256U;
+
+    fsm::hybrid const lazy{ builder, few_states };
+    ASSERT(eq(lazy.chosen(), fsm::hybrid::engine::lazy_dfa));
+    ASSERT(lazy.state_count() == 0U);
+    ASSERT(agrees(lazy, reference, all_strings("abc", 8U)));
+
+    // the cache holds a few states at a time, it is cleared over and over
+    fsm::budget few_bytes{};
+    few_bytes.max_bytes = 1024U;
+
+    fsm::hybrid const tiny{ builder, few_bytes };
+    ASSERT(eq(tiny.chosen(), fsm::hybrid::engine::lazy_dfa));
+
+    std::string input{};
+    for(int i = 0; i < 4096; ++i) {
+        input.push_back((i * 7 % 5) < 2 ? 'a' : 'b');
+    }
+
+    auto run = tiny.initial();
+    for(char const ch : input) {
+        static_cast<void>(tiny.step(run, ch));
+    }
+
+    bool const flushed = run.cache->flushes > 0U;
+    ASSERT(flushed);
+    ASSERT(tiny.is_accepting(run) == fsm::accepts(reference, input));
+    ASSERT(agrees(tiny, reference, all_strings("ab", 12U)));
+}
+
+TEST("[Hybrid] the lazy DFA keeps its states across matches")
+{
+    auto const builder = make_blowup(10);
+    fsm::budget few_states{};
+    few_states.max_states = 256U;
+
+    fsm::hybrid const lazy{ builder, few_states };
+    ASSERT(eq(lazy.chosen(), fsm::hybrid::engine::lazy_dfa));
+    ASSERT(fsm::accepts(lazy, "babbbbbbbbbb"));
+
+    // the states the match above found are there from the start
+    auto const run = lazy.initial();
+    bool const kept = run.cache->subsets.size() > 1U;
+    ASSERT(kept);
+
+    // a run going on at the same time gets a cache of its own
+    auto const other = lazy.initial();
+    ASSERT(other.cache.get() != run.cache.get());
+    ASSERT(other.cache->subsets.size() == 1U);
+}
+
+TEST("[Hybrid] lambda edges do not accept the byte 0")
+{
+    // a catch-all over every byte but 0, linked to itself by a lambda edge
+    fsm::builder builder{};
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, fsm::lambda, 1);
+    for(int byte = 1; byte < 256; ++byte) {
+        builder.add_transition(1, static_cast<char>(byte), 1);
+    }
+
+    fsm::budget no_states{};
+    no_states.max_states = 0U;
+
+    fsm::hybrid const lazy{ builder, no_states };
+    ASSERT(eq(lazy.chosen(), fsm::hybrid::engine::lazy_dfa));
+
+    using namespace std::string_literals;
+    for(auto const& input : { "a"s, "abc"s, "a\0"s, "ab\0c"s }) {
+        ASSERT(fsm::accepts(lazy, input) == (input.find('\0') == input.npos));
+    }
+}
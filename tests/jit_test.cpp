@@ -0,0 +1,117 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "jit.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto agrees(fsm::jit const& compiled,
+                          fsm::dfa const& reference,
+                          std::vector<std::string> const& inputs) -> bool
+{
+    for(auto const& input : inputs) {
+        if(compiled.accepts(input) != fsm::accepts(reference, input)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Numbers divisible by 7 written in decimal, with an optional sign
+[[nodiscard]] auto make_divisible() -> fsm::builder
+{
+    constexpr int base = 10;
+    constexpr int divisor = 7;
+    constexpr int sign = divisor;
+    fsm::builder builder{};
+
+    builder.set_starting_state(sign);
+    builder.set_accepting_state(0);
+
+    builder.add_transition(sign, '-', divisor + 1);
+    for(int digit = 0; digit < base; ++digit) {
+        auto const ch = static_cast<char>('0' + digit);
+
+        builder.add_transition(sign, ch, digit % divisor);
+        builder.add_transition(divisor + 1, ch, digit % divisor);
+
+        for(int rest = 0; rest < divisor; ++rest) {
+            builder.add_transition(rest, ch, (rest * base + digit) % divisor);
+        }
+    }
+
+    return builder;
+}
+
+// Anything starting with a byte above 0x7f, or exactly "\0a"
+[[nodiscard]] auto make_bytes() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    builder.set_accepting_state(3);
+
+    for(int byte = 0x80; byte <= 0xff; ++byte) {
+        builder.add_transition(0, static_cast<char>(byte), 1);
+    }
+    for(int byte = 0; byte <= 0xff; ++byte) {
+        builder.add_transition(1, static_cast<char>(byte), 1);
+    }
+    builder.add_transition(0, '\0', 2);
+    builder.add_transition(2, 'a', 3);
+
+    return builder;
+}
+
+} // namespace
+
+TEST("[JIT] same verdicts as the table")
+{
+    fsm::dfa const divisible{ make_divisible() };
+    fsm::dfa const bytes{ make_bytes() };
+
+    fsm::jit const compiled_divisible{ divisible };
+    fsm::jit const compiled_bytes{ bytes };
+
+#if defined(__linux__) && defined(__x86_64__)
+    ASSERT(compiled_divisible.native());
+    ASSERT(compiled_bytes.native());
+#endif
+
+    ASSERT(compiled_divisible.accepts("-7"));
+    ASSERT(compiled_divisible.accepts("1001"));
+    ASSERT(!compiled_divisible.accepts("1000"));
+    ASSERT(agrees(compiled_divisible, divisible, all_strings("0179-x", 5U)));
+
+    std::string const zero_a{ "\0a", 2U };
+    ASSERT(compiled_bytes.accepts(zero_a));
+    ASSERT(compiled_bytes.accepts("\xff"));
+    ASSERT(agrees(compiled_bytes,
+                  bytes,
+                  all_strings(std::string{ "\0a\x7f\x80\xff", 5U }, 4U)));
+}
+
+TEST("[JIT] moves keep the code")
+{
+    fsm::dfa const divisible{ make_divisible() };
+    fsm::jit compiled{ divisible };
+    auto const native = compiled.native();
+
+    fsm::jit moved{ std::move(compiled) };
+    ASSERT(moved.native() == native);
+    ASSERT(moved.accepts("14"));
+    ASSERT(!moved.accepts("15"));
+
+    fsm::jit other{ fsm::dfa{ make_bytes() } };
+    other = std::move(moved);
+    ASSERT(other.accepts("21"));
+}
@@ -0,0 +1,90 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "layout.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// Counter of 'a's modulo 5 with builder ids scattered on purpose, 'b' goes
+// back to the start from anywhere, 'c' leads to a cold cycle of its own
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    std::vector<int> const ids{ 40, 7, 23, 3, 31 };
+    std::vector<int> const cold{ 11, 19 };
+    fsm::builder builder{};
+
+    builder.set_starting_state(ids[0]);
+    builder.set_accepting_state(ids[0]);
+    builder.set_accepting_state(cold[1]);
+
+    for(std::size_t i = 0; i < ids.size(); ++i) {
+        builder.add_transition(ids[i], 'a', ids[(i + 1U) % ids.size()]);
+        builder.add_transition(ids[i], 'b', ids[0]);
+    }
+    builder.add_transition(ids[1], 'c', cold[0]);
+    builder.add_transition(cold[0], 'c', cold[1]);
+    builder.add_transition(cold[1], 'c', cold[0]);
+
+    return builder;
+}
+
+[[nodiscard]] auto same_verdicts(fsm::dfa const& a, fsm::dfa const& b) -> bool
+{
+    for(auto const& input : all_strings("abcd", 6U)) {
+        if(fsm::accepts(a, input) != fsm::accepts(b, input)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+TEST("[Layout] every strategy keeps the language")
+{
+    fsm::dfa const original{ make_builder() };
+    std::string const sample{ "aaaaabaaaaaaaaaabaaacccc" };
+
+    for(auto const strategy : { fsm::layout::bfs,
+                                fsm::layout::frequency,
+                                fsm::layout::co_access }) {
+        auto const relaid_out = original.with_layout(strategy, sample);
+
+        ASSERT(same_verdicts(original, relaid_out));
+        ASSERT(relaid_out.table().state_count() ==
+               original.table().state_count());
+    }
+}
+
+TEST("[Layout] hot states come first")
+{
+    fsm::dfa const original{ make_builder() };
+
+    auto const bfs = original.with_layout(fsm::layout::bfs);
+    ASSERT(bfs.table().start() == 0);
+    ASSERT(bfs.table().step(0, 'a') == 1);
+
+    // the walk spends most of its time in the cold cycle
+    auto const frequency =
+        original.with_layout(fsm::layout::frequency, "accccccc");
+    ASSERT(frequency.table().id_of(0) == 11);
+
+    // 'c' is taken the most, its two ends end up next to each other
+    auto const co_access =
+        original.with_layout(fsm::layout::co_access, "accccccccccc");
+    auto const& table = co_access.table();
+    int const first = table.step(table.step(table.start(), 'a'), 'c');
+    int const second = table.step(first, 'c');
+
+    int const gap = second - first;
+
+    ASSERT(table.id_of(first) == 11);
+    ASSERT(gap == 1);
+}
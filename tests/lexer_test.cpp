@@ -0,0 +1,147 @@
+#define MAIN_EXECUTABLE
+#include "fsm_builder.hpp"
+#include "lexer.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto literal(std::string const& text) -> fsm::builder
+{
+    fsm::builder builder{};
+    int state{ 0 };
+
+    builder.set_starting_state(0);
+    for(char const ch : text) {
+        builder.add_transition(state, ch, state + 1);
+        ++state;
+    }
+    builder.set_accepting_state(state);
+
+    return builder;
+}
+
+// One or more characters in [first, last]
+[[nodiscard]] auto repeat(char const first, char const last) -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    for(char ch = first; ch <= last; ++ch) {
+        builder.add_transition(0, ch, 1);
+        builder.add_transition(1, ch, 1);
+    }
+
+    return builder;
+}
+
+enum rule : int
+{
+    keyword_if,
+    identifier,
+    number,
+    space
+};
+
+} // namespace
+
+TEST("[Lexer] maximal munch")
+{
+    fsm::lexer const lexer{ { literal("if"),
+                              repeat('a', 'z'),
+                              repeat('0', '9'),
+                              repeat(' ', ' ') } };
+
+    std::string const input{ "if iff  x1 9" };
+    auto const tokens = lexer.tokenize(input);
+
+    std::vector<std::string_view> const texts{
+        "if", " ", "iff", "  ", "x", "1", " ", "9"
+    };
+    std::vector<int> const rules{ keyword_if, space,      identifier, space,
+                                  identifier, number,     space,      number };
+
+    ASSERT(tokens.size() == texts.size());
+
+    for(auto i = 0U; i < tokens.size(); ++i) {
+        ASSERT(tokens[i].text == texts[i]);
+        ASSERT(tokens[i].rule == rules[i]);
+    }
+
+    // tokens are slices of the input, not copies
+    ASSERT(tokens.front().text.data() == input.data());
+}
+
+TEST("[Lexer] priority and unknown characters")
+{
+    // the identifier rule comes first, so it shadows the keyword
+    fsm::lexer const lexer{ { repeat('a', 'z'), literal("if") } };
+    auto const tokens = lexer.tokenize("if#");
+
+    ASSERT(tokens.size() == 2U);
+    ASSERT(tokens[0].rule == 0);
+    ASSERT(tokens[1].text == "#");
+    ASSERT(tokens[1].rule == fsm::lexer::no_rule);
+
+    std::size_t position{ 0 };
+    auto const token = lexer.next_token("abc def", position);
+
+    ASSERT(token.text == "abc");
+    ASSERT(position == 3U);
+}
+
+TEST("[Lexer] linear on scans that read far ahead")
+{
+    // a*b
+    fsm::builder ab{};
+    ab.set_starting_state(0);
+    ab.set_accepting_state(1);
+    ab.add_transition(0, 'a', 0);
+    ab.add_transition(0, 'b', 1);
+
+    fsm::lexer const lexer{ { literal("a"), ab } };
+
+    // every token is a single 'a' found after reading to the end for a 'b':
+    // quadratic without the memo, this is 2^34 steps
+    std::string const input(std::size_t{ 1 } << 17U, 'a');
+    std::size_t position{ 0 };
+    fsm::lexer::memo scans{};
+    std::size_t count{ 0 };
+    bool singles{ true };
+
+    while(position < input.size()) {
+        auto const token = lexer.next_token(input, position, scans);
+
+        singles = singles && token.text.size() == 1U && token.rule == 0;
+        ++count;
+    }
+
+    ASSERT(singles);
+    ASSERT(count == input.size());
+    // each (state, position) pair failed once at most
+    bool const bounded = scans.failed.size() < input.size();
+    ASSERT(bounded);
+
+    auto const tokens = lexer.tokenize(input + "b");
+    ASSERT(tokens.size() == 1U);
+    ASSERT(tokens.front().rule == 1);
+    ASSERT(tokens.front().text.size() == input.size() + 1U);
+}
+
+TEST("[Lexer] memo keys past 4 GiB")
+{
+    // positions aren't truncated: the same state at positions 2^32 apart
+    // are two pairs
+    fsm::lexer::memo scans{};
+    auto const far = (std::size_t{ 1 } << 32U) + 5U;
+
+    scans.failed.emplace(5U, 3);
+    ASSERT(scans.failed.count({ far, 3 }) == 0U);
+
+    scans.failed.emplace(far, 3);
+    ASSERT(scans.failed.size() == 2U);
+}
@@ -1,8 +1,11 @@
 #define MAIN_EXECUTABLE
 #include "fsm_builder.hpp"
 #include "lnfa.hpp"
+#include "nfa.hpp"
+#include "sparse_set.hpp"
 #include "test.hpp"
 
+#include <stdexcept>
 #include <string>
 
 using vec = std::vector<int>;
@@ -56,3 +59,167 @@ TEST("[LNFA]")
         lnfa.reset();
     }
 }
+
+TEST("[LNFA] lambda cycle")
+{
+    using fsm::lambda;
+
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+
+    // 0 -> 1 -> 2 -> 0 is a lambda cycle
+    builder.add_transition(0, lambda, 1);
+    builder.add_transition(1, lambda, 2);
+    builder.add_transition(2, lambda, 0);
+    builder.add_transition(1, 'a', 3);
+    builder.add_transition(3, lambda, 4);
+    builder.add_transition(4, 'b', 2);
+    builder.add_transition(4, lambda, 3);
+
+    fsm::impl::lambda_closures const closures{ builder };
+
+    ASSERT(closures.state_count() == 5U);
+    ASSERT(closures.component_count() == 2U);
+    ASSERT(closures.component_of(0) == closures.component_of(2));
+    ASSERT(closures.component_of(3) == closures.component_of(4));
+    auto const of_2 = closures.of(2);
+    auto const of_4 = closures.of(4);
+    ASSERT(eq(vec(of_2.begin(), of_2.end()), vec({ 0, 1, 2 })));
+    ASSERT(eq(vec(of_4.begin(), of_4.end()), vec({ 3, 4 })));
+
+    fsm::lnfa lnfa{ builder };
+
+    ASSERT(!fsm::accepts(lnfa, ""));
+    lnfa.reset();
+    ASSERT(fsm::accepts(lnfa, "a"));
+    lnfa.reset();
+    ASSERT(fsm::accepts(lnfa, "abababa"));
+    lnfa.reset();
+    ASSERT(!fsm::accepts(lnfa, "ab"));
+    lnfa.reset();
+
+    fsm::nfa nfa{ lnfa.to_nfa() };
+
+    ASSERT(fsm::accepts(nfa, "aba"));
+    nfa.reset();
+    ASSERT(!fsm::accepts(nfa, "abab"));
+}
+
+TEST("[LNFA] merge every group of identical states")
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(5);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 2);
+    builder.add_transition(0, 'c', 3);
+    builder.add_transition(0, 'd', 4);
+    // 1 and 2 are identical, so are 3 and 4
+    builder.add_transition(1, 'x', 5);
+    builder.add_transition(2, 'x', 5);
+    builder.add_transition(3, 'y', 5);
+    builder.add_transition(4, 'y', 5);
+
+    fsm::lnfa lnfa{ builder };
+    auto const result = lnfa.to_nfa();
+
+    ASSERT(fsm::impl::state_count(result) == 4U);
+
+    fsm::nfa nfa{ result };
+
+    ASSERT(fsm::accepts(nfa, "ax"));
+    nfa.reset();
+    ASSERT(fsm::accepts(nfa, "bx"));
+    nfa.reset();
+    ASSERT(fsm::accepts(nfa, "dy"));
+    nfa.reset();
+    ASSERT(!fsm::accepts(nfa, "ay"));
+}
+
+TEST("[LNFA] sparse set")
+{
+    fsm::impl::sparse_set set{ 10U };
+
+    ASSERT(set.empty());
+    ASSERT(set.insert(7));
+    ASSERT(set.insert(2));
+    ASSERT(!set.insert(7));
+    ASSERT(set.contains(2));
+    ASSERT(!set.contains(3));
+    ASSERT(set.size() == 2U);
+    ASSERT(eq(vec(set.begin(), set.end()), vec({ 7, 2 })));
+
+    set.clear();
+    ASSERT(set.empty());
+    ASSERT(!set.contains(7));
+    ASSERT(set.insert(2));
+    ASSERT(eq(vec(set.begin(), set.end()), vec({ 2 })));
+    ASSERT(set.capacity() == 10U);
+}
+
+TEST("[LNFA] one hundred thousand states")
+{
+    using fsm::lambda;
+    constexpr int n = 100000;
+    fsm::builder builder{};
+
+    // (a|b)*a(a|b){n}, through a lambda transition in the middle
+    builder.set_starting_state(0);
+    builder.set_accepting_state(n + 2);
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'b', 0);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, lambda, 2);
+
+    for(int state = 2; state < n + 2; ++state) {
+        builder.add_transition(state, 'a', state + 1);
+        builder.add_transition(state, 'b', state + 1);
+    }
+
+    fsm::lnfa const lnfa{ builder };
+    std::string input(static_cast<std::size_t>(n) + 50U, 'b');
+
+    ASSERT(!fsm::accepts(lnfa, input));
+
+    input[49] = 'a';
+    ASSERT(fsm::accepts(lnfa, input));
+
+    input += 'b';
+    ASSERT(!fsm::accepts(lnfa, input));
+}
+
+TEST("[LNFA] state ids must be dense")
+{
+    auto const rejected = [](fsm::builder const& builder) -> bool {
+        try {
+            fsm::lnfa const lnfa{ builder };
+        }
+        catch(std::invalid_argument const&) {
+            return true;
+        }
+        return false;
+    };
+
+    fsm::builder negative{};
+    negative.set_starting_state(0);
+    negative.set_accepting_state(-1);
+    negative.add_transition(0, 'a', -1);
+    ASSERT(rejected(negative));
+
+    fsm::builder sparse{};
+    sparse.set_starting_state(0);
+    sparse.set_accepting_state(1'000'000'000);
+    sparse.add_transition(0, 'a', 1'000'000'000);
+    ASSERT(rejected(sparse));
+
+    // a few gaps are fine
+    fsm::builder gaps{};
+    gaps.set_starting_state(10);
+    gaps.set_accepting_state(500);
+    gaps.add_transition(10, 'a', 500);
+    ASSERT(!rejected(gaps));
+}
@@ -0,0 +1,219 @@
+#define MAIN_EXECUTABLE
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "test.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+using pos = std::optional<std::size_t>;
+
+template<typename T, typename U>
+[[nodiscard]] auto eq(T const& a, U const& b) noexcept -> bool
+{
+    return a == b;
+}
+
+namespace {
+
+// ab*c?
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+    builder.set_accepting_state(2);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'c', 2);
+
+    return builder;
+}
+
+// a.* where '.' is any byte, plus a branch on 'b' that never accepts
+[[nodiscard]] auto make_decided_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(1);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 2);
+    builder.add_transition(2, 'b', 2);
+
+    for(int byte = 0; byte < 256; ++byte) {
+        builder.add_transition(1, static_cast<char>(byte), 1);
+    }
+
+    return builder;
+}
+
+// Records of a's and b's, each one ended by ';'
+[[nodiscard]] auto make_records_builder() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(0);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 1);
+    builder.add_transition(1, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, ';', 0);
+
+    return builder;
+}
+
+// Ends of the accepted prefixes, one accepts call per prefix
+template<typename Engine>
+[[nodiscard]] auto prefix_by_prefix(Engine const& engine,
+                                    std::string const& input)
+    -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> result{};
+
+    for(std::size_t end = 0; end <= input.size(); ++end) {
+        if(fsm::accepts(engine, std::string_view{ input }.substr(0, end))) {
+            result.push_back(end);
+        }
+    }
+
+    return result;
+}
+
+template<typename Engine>
+[[nodiscard]] auto same_prefixes(Engine const& engine,
+                                 std::string const& input) -> bool
+{
+    auto const expected = prefix_by_prefix(engine, input);
+
+    std::vector<std::size_t> called{};
+    fsm::for_each_accepting_prefix(
+        engine, input, [&](std::size_t const end) { called.push_back(end); });
+
+    std::vector<std::size_t> buffer(input.size() + 1U, 0U);
+    auto const count = fsm::accepting_prefixes(
+        engine, input, buffer.data(), buffer.size());
+    buffer.resize(count);
+
+    std::vector<std::uint64_t> bitmap(input.size() / 64U + 1U, ~0ULL);
+    auto const marked =
+        fsm::mark_accepting_prefixes(engine, input, bitmap.data());
+    std::vector<std::size_t> from_bitmap{};
+    for(std::size_t end = 0; end <= input.size(); ++end) {
+        if(((bitmap[end / 64U] >> (end % 64U)) & 1U) != 0U) {
+            from_bitmap.push_back(end);
+        }
+    }
+
+    return called == expected && buffer == expected &&
+           from_bitmap == expected && marked == expected.size();
+}
+
+template<typename Engine>
+[[nodiscard]] auto stops_early(Engine const& engine) -> bool
+{
+    auto dead = engine.initial();
+    auto all = engine.initial();
+
+    bool const stopped = !engine.step(dead, 'b') && !engine.step(all, 'a');
+    auto const prefix = fsm::match_prefix(engine, "axyz");
+
+    return stopped && !engine.is_accepting(dead) && engine.is_accepting(all) &&
+           prefix.consumed == 4U && prefix.longest == pos{ 4U } &&
+           fsm::accepts(engine, "a\0b") && !fsm::accepts(engine, "bbb");
+}
+
+} // namespace
+
+TEST("[Match] longest prefix")
+{
+    fsm::dfa dfa{ make_builder() };
+
+    auto const none = fsm::match_prefix(dfa, "xab");
+    ASSERT(none.consumed == 0U);
+    ASSERT(!none.longest.has_value());
+
+    auto const all = fsm::match_prefix(dfa, "abbc");
+    ASSERT(all.consumed == 4U);
+    ASSERT(eq(all.longest, pos{ 4U }));
+
+    // stops at the first 'c' that can't be followed by anything
+    auto const partial = fsm::match_prefix(dfa, "abbcbb");
+    ASSERT(partial.consumed == 4U);
+    ASSERT(eq(partial.longest, pos{ 4U }));
+
+    ASSERT(eq(fsm::longest_match(dfa, "abx"), pos{ 2U }));
+    ASSERT(!fsm::longest_match(dfa, "").has_value());
+}
+
+TEST("[Match] empty prefix and every engine")
+{
+    using fsm::lambda;
+    fsm::builder builder{ make_builder() };
+
+    builder.add_transition(0, lambda, 3);
+    builder.set_accepting_state(3);
+
+    fsm::lnfa lnfa{ builder };
+    fsm::nfa nfa{ make_builder() };
+
+    ASSERT(eq(fsm::longest_match(lnfa, ""), pos{ 0U }));
+    ASSERT(eq(fsm::longest_match(lnfa, "x"), pos{ 0U }));
+    ASSERT(eq(fsm::longest_match(lnfa, "abc"), pos{ 3U }));
+    ASSERT(eq(fsm::longest_match(nfa, "abca"), pos{ 3U }));
+    ASSERT(!fsm::longest_match(nfa, "b").has_value());
+}
+
+TEST("[Match] stop once the outcome is decided")
+{
+    fsm::dfa dfa{ make_decided_builder() };
+    fsm::nfa nfa{ make_decided_builder() };
+    fsm::lnfa lnfa{ make_decided_builder() };
+
+    ASSERT(stops_early(dfa));
+    ASSERT(stops_early(nfa));
+    ASSERT(stops_early(lnfa));
+
+    auto const& table = dfa.table();
+    int const start = table.start();
+    bool const accept_all = table.accepts_all(table.step(start, 'a'));
+
+    ASSERT(accept_all);
+    ASSERT(table.step(start, 'b') == fsm::impl::dfa_table::dead);
+}
+
+TEST("[Match] every accepting prefix")
+{
+    std::string const records{ "ab;b;;aab;ba" };
+    fsm::dfa const dfa{ make_records_builder() };
+    fsm::nfa const nfa{ make_records_builder() };
+    fsm::lnfa const lnfa{ make_records_builder() };
+
+    ASSERT(same_prefixes(dfa, records));
+    ASSERT(same_prefixes(nfa, records));
+    ASSERT(same_prefixes(lnfa, records));
+
+    std::size_t boundaries[2]{};
+    auto const count = fsm::accepting_prefixes(
+        dfa, records, boundaries, std::size(boundaries));
+    // the empty record ends it: 0, 3 and 5, the buffer only holds two
+    ASSERT(count == 3U);
+    ASSERT(boundaries[0] == 0U);
+    ASSERT(boundaries[1] == 3U);
+
+    // every prefix after the 'a' is accepted, over several bitmap words
+    std::string const decided = "a" + std::string(150U, 'x');
+    ASSERT(same_prefixes(fsm::dfa{ make_decided_builder() }, decided));
+    ASSERT(same_prefixes(fsm::lnfa{ make_decided_builder() }, decided));
+    ASSERT(same_prefixes(fsm::dfa{ make_decided_builder() }, "bbb"));
+}
@@ -0,0 +1,187 @@
+#define MAIN_EXECUTABLE
+#include "automata.hpp"
+#include "cursor.hpp"
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "pipeline.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+template<typename T, typename U>
+[[nodiscard]] auto eq(T const& a, U const& b) noexcept -> bool
+{
+    return a == b;
+}
+
+namespace {
+
+[[nodiscard]] auto make_lines(std::size_t const count)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> lines{};
+
+    for(std::size_t i = 0; i < count; ++i) {
+        std::string line{ i % 3U == 0U ? "b" : "a" };
+
+        for(std::size_t j = 0; j < i % 11U; ++j) {
+            line.push_back((i + j) % 2U == 0U ? 'a' : 'b');
+        }
+        lines.push_back(line);
+    }
+
+    // longer than any buffer of the tests
+    lines.push_back(std::string(100U, 'a') + "b");
+    lines.emplace_back();
+
+    return lines;
+}
+
+} // namespace
+
+TEST("[Pipeline] bounded queue")
+{
+    fsm::bounded_queue<int> queue{ 2U };
+
+    ASSERT(queue.push(1));
+    ASSERT(queue.push(2));
+
+    // the third push waits for a pop
+    std::thread producer{ [&queue] { static_cast<void>(queue.push(3)); } };
+
+    ASSERT(eq(queue.pop(), 1));
+    ASSERT(eq(queue.pop(), 2));
+    ASSERT(eq(queue.pop(), 3));
+    producer.join();
+
+    queue.close();
+    ASSERT(!queue.push(4));
+    ASSERT(eq(queue.pop(), std::nullopt));
+
+    bool thrown{ false };
+    try {
+        fsm::bounded_queue<int> const empty{ 0U };
+    }
+    catch(std::invalid_argument const&) {
+        thrown = true;
+    }
+    ASSERT(thrown);
+}
+
+TEST("[Pipeline] reorder window")
+{
+    fsm::impl::reorder_window window{ 2U };
+
+    ASSERT(window.enter(0U));
+    ASSERT(window.enter(1U));
+
+    // chunk 2 waits for the sink to be done with chunk 0
+    std::atomic<bool> entered{ false };
+    std::thread matcher{ [&] { entered = window.enter(2U); } };
+
+    window.advance(1U);
+    matcher.join();
+    ASSERT(entered.load());
+
+    // closing wakes up a matcher still waiting
+    std::thread waiting{ [&] { entered = window.enter(5U); } };
+
+    window.close();
+    waiting.join();
+    ASSERT(!entered.load());
+}
+
+TEST("[Pipeline] every line in order")
+{
+    auto const shared = fsm::share(fsm::dfa{ make_a_ab_star_b() });
+    auto const lines = make_lines(500U);
+
+    std::string text{};
+    for(auto const& line : lines) {
+        text += line + '\n';
+    }
+    // the last line has no newline
+    text += "aab";
+
+    for(std::size_t const matchers : { 1U, 3U }) {
+        fsm::pipeline_options options{};
+        options.buffer_size = 7U;
+        options.queue_capacity = 2U;
+        options.matchers = matchers;
+
+        std::istringstream input{ text };
+        std::vector<bool> verdicts{};
+        bool in_order{ true };
+
+        auto const stats = fsm::match_lines(
+            shared,
+            input,
+            [&](std::size_t const line, bool const accepted) {
+                in_order = in_order && line == verdicts.size();
+                verdicts.push_back(accepted);
+            },
+            options);
+
+        ASSERT(in_order);
+        ASSERT(stats.lines == lines.size() + 1U);
+        ASSERT(stats.bytes == text.size());
+        ASSERT(verdicts.size() == stats.lines);
+
+        std::size_t accepted{ 0 };
+        bool agrees{ true };
+        for(std::size_t i = 0; i < lines.size(); ++i) {
+            agrees = agrees && verdicts[i] == fsm::accepts(*shared, lines[i]);
+            accepted += verdicts[i] ? 1U : 0U;
+        }
+        ASSERT(agrees);
+        ASSERT(verdicts.back());
+        ASSERT(stats.accepted == accepted + 1U);
+    }
+}
+
+TEST("[Pipeline] errors stop every stage")
+{
+    auto const shared = fsm::share(fsm::dfa{ make_a_ab_star_b() });
+    std::string text{};
+    for(auto const& line : make_lines(2000U)) {
+        text += line + '\n';
+    }
+
+    fsm::pipeline_options options{};
+    options.buffer_size = 16U;
+    options.queue_capacity = 1U;
+
+    std::istringstream input{ text };
+    std::size_t seen{ 0 };
+    bool thrown{ false };
+
+    try {
+        static_cast<void>(fsm::match_lines(
+            shared,
+            input,
+            [&seen](std::size_t, bool) {
+                if(++seen == 10U) {
+                    throw std::runtime_error{ "sink failed" };
+                }
+            },
+            options));
+    }
+    catch(std::runtime_error const&) {
+        thrown = true;
+    }
+
+    ASSERT(thrown);
+    ASSERT(seen == 10U);
+
+    std::istringstream empty{};
+    auto const stats = fsm::match_lines(
+        shared, empty, [](std::size_t, bool) {}, options);
+    ASSERT(stats.lines == 0U);
+}
@@ -0,0 +1,88 @@
+#define MAIN_EXECUTABLE
+#include "equivalence.hpp"
+#include "fsm.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "profile.hpp"
+#include "test.hpp"
+
+#include <string>
+#include <vector>
+
+template<typename T, typename U>
+[[nodiscard]] auto eq(T const& a, U const& b) noexcept -> bool
+{
+    return a == b;
+}
+
+namespace {
+
+// (x|y|z)*a followed by b's, the common bytes listed last and interleaved
+[[nodiscard]] auto make_builder() -> fsm::builder
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+
+    builder.add_transition(0, 'x', 0);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'y', 0);
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'z', 0);
+    builder.add_transition(1, lambda, 2);
+    builder.add_transition(2, 'c', 2);
+    builder.add_transition(2, 'b', 3);
+    builder.add_transition(3, 'c', 3);
+    builder.add_transition(3, 'b', 3);
+
+    return builder;
+}
+
+} // namespace
+
+TEST("[Profile] counts the transitions taken")
+{
+    auto const builder = make_builder();
+    auto const counts = fsm::profile(builder, { "aab", "zab", "q" });
+
+    // 0 loops on every byte but b, so it is active before each one
+    ASSERT(counts.visits.at(0) == 7U);
+    ASSERT(eq(counts.hits.at(0), std::vector<std::size_t>{ 0, 3, 0, 3, 1 }));
+    ASSERT(eq(counts.hits.at(2), std::vector<std::size_t>{ 0, 2 }));
+    ASSERT(counts.visits.count(3) == 0U);
+}
+
+TEST("[Profile] optimized builders keep their language")
+{
+    auto const builder = make_builder();
+    std::vector<std::string> const corpus{ "aab", "ab", "aaaab", "abbbb" };
+    auto const optimized =
+        fsm::optimize(builder, fsm::profile(builder, corpus));
+
+    ASSERT(fsm::equivalent(builder, optimized).equal);
+    ASSERT(fsm::impl::grouped_by_byte(optimized));
+    ASSERT(!fsm::impl::grouped_by_byte(builder));
+
+    // the 'a' transitions of state 0 come first, together
+    auto const& first = optimized.get_configuration().at(0);
+    ASSERT(first.size() == 5U);
+    ASSERT(first[0].on == 'a');
+    ASSERT(first[1].on == 'a');
+
+    // the scans that stop early still see every transition they need
+    auto const without_lambda = fsm::lnfa{ builder }.to_nfa();
+    fsm::nfa const nfa{ without_lambda };
+    fsm::nfa const optimized_nfa{ fsm::optimize(
+        without_lambda, fsm::profile(without_lambda, corpus)) };
+    fsm::lnfa const lnfa{ builder };
+    fsm::lnfa const optimized_lnfa{ optimized };
+
+    for(std::string const input : { "", "a", "ab", "xyzab", "abcb", "aac" }) {
+        ASSERT(fsm::accepts(optimized_lnfa, input) ==
+               fsm::accepts(lnfa, input));
+        ASSERT(fsm::accepts(optimized_nfa, input) == fsm::accepts(nfa, input));
+    }
+}
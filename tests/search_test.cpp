@@ -0,0 +1,175 @@
+#define MAIN_EXECUTABLE
+#include "dfa.hpp"
+#include "fsm_builder.hpp"
+#include "search.hpp"
+#include "test.hpp"
+
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// "ab" followed by one or more 'c' or 'd'
+[[nodiscard]] auto make_pattern() -> fsm::builder
+{
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(3);
+
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'b', 2);
+    builder.add_transition(2, 'c', 3);
+    builder.add_transition(2, 'd', 3);
+    builder.add_transition(3, 'c', 3);
+    builder.add_transition(3, 'd', 3);
+
+    return builder;
+}
+
+// Every offset, checked with the anchored automaton
+[[nodiscard]] auto naive_contains(fsm::dfa const& dfa,
+                                  std::string_view const text) -> bool
+{
+    for(std::size_t start = 0; start <= text.size(); ++start) {
+        for(std::size_t end = start; end <= text.size(); ++end) {
+            if(fsm::accepts(dfa, text.substr(start, end - start))) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// The match ending first, of those the one starting first, checking every
+// substring with the anchored automaton
+[[nodiscard]] auto naive_find(fsm::dfa const& dfa, std::string_view const text)
+    -> std::optional<fsm::match>
+{
+    for(std::size_t end = 0; end <= text.size(); ++end) {
+        for(std::size_t start = 0; start <= end; ++start) {
+            if(fsm::accepts(dfa, text.substr(start, end - start))) {
+                return fsm::match{ start, end };
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+TEST("[Search] literal prefilter")
+{
+    fsm::dfa const dfa{ make_pattern() };
+    fsm::searcher const searcher{ dfa };
+
+    ASSERT(searcher.prefix() == "ab");
+
+    std::string const text{ "xxabxabcdcyyabd" };
+    auto const found = searcher.find(text);
+
+    ASSERT(found.has_value());
+    ASSERT(found->start == 5U);
+    // the earliest end
+    ASSERT(found->end == 8U);
+
+    auto const all = searcher.find_all(text);
+
+    ASSERT(all.size() == 2U);
+    ASSERT(all[1].start == 12U);
+    ASSERT(all[1].end == 15U);
+
+    ASSERT(!searcher.contains("abab ba"));
+}
+
+TEST("[Search] first byte prefilter")
+{
+    // (a|b)+c
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 1);
+    builder.add_transition(1, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'c', 2);
+
+    fsm::dfa const dfa{ builder };
+    fsm::searcher const searcher{ dfa };
+
+    ASSERT(searcher.prefix().empty());
+
+    std::vector<std::string> const texts{ "",     "c",      "ac",    "xxbac",
+                                          "abxc", "bbbbbb", "cabac", "zzzc" };
+
+    for(auto const& text : texts) {
+        ASSERT(searcher.contains(text) == naive_contains(dfa, text));
+    }
+
+    auto const found = searcher.find("xxbbac");
+
+    ASSERT(found.has_value());
+    ASSERT(found->start == 2U);
+    ASSERT(found->end == 6U);
+}
+
+TEST("[Search] match starts from the reverse DFA")
+{
+    // a(b|c)*d|b+d, with matches overlapping in many ways
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+    builder.set_accepting_state(4);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(1, 'b', 1);
+    builder.add_transition(1, 'c', 1);
+    builder.add_transition(1, 'd', 2);
+    builder.add_transition(0, 'b', 3);
+    builder.add_transition(3, 'b', 3);
+    builder.add_transition(3, 'd', 4);
+
+    fsm::dfa const dfa{ builder };
+    fsm::dfa const reversed = dfa.reverse();
+    fsm::searcher const searcher{ dfa };
+
+    ASSERT(fsm::accepts(reversed, "dcba"));
+    ASSERT(fsm::accepts(reversed, "dbb"));
+    ASSERT(!fsm::accepts(reversed, "abcd"));
+
+    std::mt19937 gen{ 3 };
+    std::uniform_int_distribution<int> letter{ 0, 4 };
+    bool agrees{ true };
+
+    for(int round = 0; round < 500; ++round) {
+        std::string text{};
+        for(int i = 0; i < round % 24; ++i) {
+            text.push_back(static_cast<char>('a' + letter(gen)));
+        }
+
+        auto const found = searcher.find(text);
+        auto const expected = naive_find(dfa, text);
+
+        agrees = agrees && found.has_value() == expected.has_value();
+        if(found.has_value() && expected.has_value()) {
+            agrees = agrees && found->start == expected->start &&
+                     found->end == expected->end;
+        }
+    }
+    ASSERT(agrees);
+
+    // the match starts far back, every earlier 'b' is a start that fails
+    std::string text(5000U, 'b');
+    text = "a" + text + "d";
+
+    auto const found = searcher.find(text);
+    ASSERT(found.has_value());
+    ASSERT(found->start == 0U);
+    ASSERT(found->end == text.size());
+}
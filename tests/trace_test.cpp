@@ -0,0 +1,128 @@
+#define MAIN_EXECUTABLE
+#include "dfa.hpp"
+#include "fsm_builder.hpp"
+#include "lnfa.hpp"
+#include "nfa.hpp"
+#include "test.hpp"
+#include "trace.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+class recording_sink final : public fsm::trace::sink
+{
+public:
+    std::vector<fsm::trace::event> events{};
+
+    auto on_event(fsm::trace::event const& ev) -> void override
+    {
+        events.push_back(ev);
+    }
+};
+
+[[nodiscard]] auto make_lnfa() -> fsm::builder
+{
+    using fsm::lambda;
+    fsm::builder builder{};
+
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+    builder.set_accepting_state(6);
+
+    builder.add_transition(0, 'a', 0);
+    builder.add_transition(0, 'a', 1);
+    builder.add_transition(0, 'b', 2);
+    builder.add_transition(0, lambda, 2);
+    builder.add_transition(0, lambda, 3);
+    builder.add_transition(1, lambda, 2);
+    builder.add_transition(2, 'a', 3);
+    builder.add_transition(2, lambda, 4);
+    builder.add_transition(3, 'b', 3);
+    builder.add_transition(3, lambda, 5);
+    builder.add_transition(3, 'a', 6);
+    builder.add_transition(3, 'b', 6);
+    builder.add_transition(4, 'b', 5);
+    builder.add_transition(4, 'a', 6);
+    builder.add_transition(4, lambda, 6);
+    builder.add_transition(5, lambda, 2);
+    builder.add_transition(5, 'b', 2);
+    builder.add_transition(5, lambda, 6);
+    builder.add_transition(5, 'a', 6);
+    builder.add_transition(6, 'b', 6);
+
+    return builder;
+}
+
+} // namespace
+
+TEST("[Trace] phases")
+{
+    using fsm::trace::phase;
+    recording_sink sink{};
+    auto* const previous = fsm::trace::set_sink(&sink);
+
+    fsm::lnfa lnfa{ make_lnfa() };
+    fsm::nfa nfa{ lnfa.to_nfa() };
+    fsm::dfa dfa{ nfa.to_dfa() };
+    fsm::dfa min_dfa{ dfa.minimize() };
+
+    fsm::trace::set_sink(previous);
+
+    std::vector<phase> const expected{ phase::lambda_closure,
+                                       phase::closed_transitions,
+                                       phase::identical_states,
+                                       phase::subset_construction,
+                                       phase::unreachable_removal,
+                                       phase::equivalence_merging };
+
+    ASSERT(sink.events.size() == expected.size());
+
+    for(auto i = 0U; i < expected.size(); ++i) {
+        auto const& ev = sink.events[i];
+
+        ASSERT(std::string{ name(ev.what) } == name(expected[i]));
+        ASSERT(ev.states_in != 0U);
+    }
+
+    bool const shrunk =
+        sink.events[2].states_out <= sink.events[2].states_in;
+    bool const ordered = sink.events[4].start >= sink.events[3].start;
+
+    ASSERT(shrunk);
+    ASSERT(ordered);
+}
+
+TEST("[Trace] no sink")
+{
+    ASSERT(fsm::trace::get_sink() == nullptr);
+
+    fsm::lnfa lnfa{ make_lnfa() };
+    fsm::nfa nfa{ lnfa.to_nfa() };
+
+    ASSERT(fsm::accepts(nfa, "ab"));
+}
+
+TEST("[Trace] chrome sink")
+{
+    std::ostringstream os{};
+    {
+        fsm::trace::chrome_sink sink{ os };
+        auto* const previous = fsm::trace::set_sink(&sink);
+
+        fsm::lnfa lnfa{ make_lnfa() };
+        fsm::nfa nfa{ lnfa.to_nfa() };
+
+        fsm::trace::set_sink(previous);
+    }
+
+    auto const json = os.str();
+
+    ASSERT(json.rfind("{\"traceEvents\":[", 0) == 0U);
+    ASSERT(json.find("\"name\":\"lambda_closure\"") != std::string::npos);
+    ASSERT(json.find("\"name\":\"identical_states\"") != std::string::npos);
+    ASSERT(json.find("\"ph\":\"X\"") != std::string::npos);
+    ASSERT(json.find("]}") != std::string::npos);
+}
@@ -0,0 +1,140 @@
+#define MAIN_EXECUTABLE
+#include "dfa.hpp"
+#include "fsm.hpp"
+#include "test.hpp"
+#include "utf8.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+[[nodiscard]] auto encode(std::uint32_t const cp) -> std::string
+{
+    auto byte = [](std::uint32_t const value) -> char {
+        return static_cast<char>(static_cast<unsigned char>(value));
+    };
+
+    if(cp < 0x80U) {
+        return { byte(cp) };
+    }
+    if(cp < 0x800U) {
+        return { byte(0xC0U | (cp >> 6U)), byte(0x80U | (cp & 0x3FU)) };
+    }
+    if(cp < 0x10000U) {
+        return { byte(0xE0U | (cp >> 12U)),
+                 byte(0x80U | ((cp >> 6U) & 0x3FU)),
+                 byte(0x80U | (cp & 0x3FU)) };
+    }
+
+    return { byte(0xF0U | (cp >> 18U)),
+             byte(0x80U | ((cp >> 12U) & 0x3FU)),
+             byte(0x80U | ((cp >> 6U) & 0x3FU)),
+             byte(0x80U | (cp & 0x3FU)) };
+}
+
+[[nodiscard]] auto contains(std::vector<fsm::code_point_range> const& ranges,
+                            std::uint32_t const cp) -> bool
+{
+    bool const surrogate = cp >= 0xD800U && cp <= 0xDFFFU;
+
+    for(auto const& range : ranges) {
+        if(!surrogate && cp >= range.first && cp <= range.last) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Every encoded code point is accepted exactly when it is in `ranges`
+[[nodiscard]] auto matches_decoder(
+    std::vector<fsm::code_point_range> const& ranges) -> bool
+{
+    fsm::dfa const automaton{ fsm::code_points(ranges) };
+
+    for(std::uint32_t cp = 0; cp <= 0x10FFFFU; ++cp) {
+        if(fsm::accepts(automaton, encode(cp)) != contains(ranges, cp)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+TEST("[UTF-8] accepts the encoded code points")
+{
+    ASSERT(matches_decoder({ { U'a', U'z' } }));
+    // Greek, CJK, emoticons, overlapping and unsorted
+    ASSERT(matches_decoder({ { 0x1F600, 0x1F64F },
+                             { 0x3B1, 0x3C9 },
+                             { 0x4E00, 0x9FFF },
+                             { 0x9000, 0xA000 },
+                             { U'0', U'9' } }));
+    // across every encoding length and the surrogates
+    ASSERT(matches_decoder({ { 0x7A, 0x10003 } }));
+    ASSERT(matches_decoder({ { 0xD7FF, 0xE000 }, { 0x10FFF0, 0x1FFFFF } }));
+}
+
+TEST("[UTF-8] rejects malformed sequences")
+{
+    fsm::dfa const any{ fsm::code_points({ { 0, 0x10FFFF } }) };
+
+    ASSERT(fsm::accepts(any, "\xC3\xA9"));
+    ASSERT(fsm::accepts(any, "\xF4\x8F\xBF\xBF"));
+    // overlong
+    ASSERT(!fsm::accepts(any, "\xC0\x80"));
+    ASSERT(!fsm::accepts(any, "\xE0\x80\x80"));
+    ASSERT(!fsm::accepts(any, "\xF0\x80\x80\x80"));
+    // surrogate, past U+10FFFF, truncated, stray continuation byte
+    ASSERT(!fsm::accepts(any, "\xED\xA0\x80"));
+    ASSERT(!fsm::accepts(any, "\xF4\x90\x80\x80"));
+    ASSERT(!fsm::accepts(any, "\xE2\x82"));
+    ASSERT(!fsm::accepts(any, "\x80"));
+    ASSERT(!fsm::accepts(any, "ab"));
+}
+
+TEST("[UTF-8] shares prefixes and suffixes")
+{
+    // start, accept, one pending continuation byte
+    fsm::dfa const two_bytes{ fsm::code_points({ { 0x80, 0x7FF } }) };
+    ASSERT(two_bytes.table().state_count() == 3U);
+
+    // the minimal automaton of well-formed UTF-8: two and three pending
+    // continuation bytes, plus E0, ED, F0 and F4 restricting the next one
+    fsm::dfa const any{ fsm::code_points({ { 0, 0x10FFFF } }) };
+    ASSERT(any.table().state_count() == 9U);
+
+    // ASCII, 80-8F, 90-9F, A0-BF, C2-DF, E0, E1-EC with EE-EF, ED, F0, F1-F3,
+    // F4, and the bytes never starting a code point
+    ASSERT(any.table().class_count() == 12U);
+
+    // U+00C0-U+00C5 and U+00D0-U+00D5 share C3 and the accepting state
+    fsm::dfa const latin{ fsm::code_points({ { 0xC0, 0xC5 },
+                                             { 0xD0, 0xD5 } }) };
+    ASSERT(latin.table().state_count() == 3U);
+    ASSERT(fsm::accepts(latin, "\xC3\x85"));
+    ASSERT(fsm::accepts(latin, "\xC3\x90"));
+    ASSERT(!fsm::accepts(latin, "\xC3\x88"));
+}
+
+TEST("[UTF-8] composes with other transitions")
+{
+    // [a-z] followed by Greek letters
+    fsm::builder builder{};
+    builder.set_starting_state(0);
+    builder.set_accepting_state(2);
+
+    int next_free = fsm::add_code_points(builder, 0, 1, { { U'a', U'z' } }, 3);
+    next_free =
+        fsm::add_code_points(builder, 1, 2, { { 0x3B1, 0x3C9 } }, next_free);
+    ASSERT(next_free == 5);
+
+    fsm::dfa const automaton{ builder };
+    ASSERT(fsm::accepts(automaton, "x\xCE\xB1"));
+    ASSERT(!fsm::accepts(automaton, "x\xCE\xB0"));
+    ASSERT(!fsm::accepts(automaton, "xy"));
+}
@@ -0,0 +1,55 @@
+#include "codegen.hpp"
+#include "dfa.hpp"
+#include "spec.hpp"
+
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// lfa_generate <spec> <name> <header> <source>
+//
+// Minimizes the DFA described by <spec> and writes a direct-coded matcher
+// fsm::generated::<name> to <header> and <source>.
+auto main(int argc, char* argv[]) -> int
+{
+    constexpr int expected_args = 5;
+
+    if(argc != expected_args) {
+        std::cerr << "usage: lfa_generate <spec> <name> <header> <source>\n";
+        return 1;
+    }
+
+    std::string const spec_path{ argv[1] };
+    std::string const name{ argv[2] };
+    std::string const header_path{ argv[3] };
+    std::string const source_path{ argv[4] };
+
+    try {
+        std::ifstream spec{ spec_path };
+
+        if(!spec) {
+            std::cerr << "lfa_generate: can't open " << spec_path << '\n';
+            return 1;
+        }
+
+        fsm::dfa const automaton{ fsm::dfa{ fsm::read_spec(spec) }.minimize() };
+
+        std::ofstream header{ header_path };
+        std::ofstream source{ source_path };
+
+        fsm::write_matcher_header(name, header);
+        fsm::write_matcher_source(automaton, name, source);
+
+        if(!header || !source) {
+            std::cerr << "lfa_generate: can't write the matcher\n";
+            return 1;
+        }
+    }
+    catch(std::exception const& e) {
+        std::cerr << "lfa_generate: " << spec_path << ": " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}